@@ -1021,8 +1021,8 @@ void CollectionSystemManager::populateCustomCollection(CollectionSystemData* sys
 	// get Configuration for this Custom System
 	std::ifstream input(path);
 
-	// get all files map
-	std::unordered_map<std::string,FileData*> allFilesMap = getAllGamesCollection()->getRootFolder()->getChildrenByFilename();
+	// get all files map, keyed by the path of the games
+	const std::unordered_map<std::string,FileData*>& allFilesMap = getAllGamesCollection()->getRootFolder()->getChildrenByFilename();
 
 	// iterate list of files in config file
 	for(std::string gameKey; getline(input, gameKey); )
@@ -8,6 +8,7 @@
 #include "FileFilterIndex.h"
 #include "FileSorts.h"
 #include "InputManager.h"
+#include "LocalArtIndex.h"
 #include "Log.h"
 #include "MameNames.h"
 #include "platform.h"
@@ -17,9 +18,20 @@
 #include "Window.h"
 #include <assert.h>
 
+std::atomic<unsigned int> FileData::sDisplayGeneration(0);
+
 FileData::FileData(FileType type, const std::string& path, SystemEnvironmentData* envData, SystemData* system)
 	: mType(type), mPath(path), mSystem(system), mEnvData(envData), mSourceFileData(NULL), mParent(NULL), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
+	, mStem(Utils::FileSystem::getStem(path)), mDisplayName(nullptr), mArcadeAsset(false)
+	, mFilteredIndex(nullptr), mFilteredGeneration(0), mShowsFiltered(false), mDisplayGeneration(++sDisplayGeneration), mLetterPositionsGeneration(0)
 {
+	if(system && (system->hasPlatformId(PlatformIds::ARCADE) || system->hasPlatformId(PlatformIds::NEOGEO)))
+	{
+		MameNames* mameNames = MameNames::getInstance();
+		mDisplayName = mameNames->findRealName(mStem);
+		mArcadeAsset = mameNames->isBios(mStem) || mameNames->isDevice(mStem);
+	}
+
 	// metadata needs at least a name field (since that's what getName() will return)
 	if(metadata.get("name").empty())
 		metadata.set("name", getDisplayName());
@@ -38,15 +50,6 @@ FileData::~FileData()
 	mChildren.clear();
 }
 
-std::string FileData::getDisplayName() const
-{
-	std::string stem = Utils::FileSystem::getStem(mPath);
-	if(mSystem && mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO))
-		stem = MameNames::getInstance()->getRealName(stem);
-
-	return stem;
-}
-
 std::string FileData::getCleanName() const
 {
 	return Utils::String::removeParenthesis(this->getDisplayName());
@@ -63,18 +66,7 @@ const std::string FileData::getThumbnailPath() const
 
 		// no image, try to use local image
 		if(thumbnail.empty() && Settings::getInstance()->getBool("LocalArt"))
-		{
-			const char* extList[2] = { ".png", ".jpg" };
-			for(int i = 0; i < 2; i++)
-			{
-				if(thumbnail.empty())
-				{
-					std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-image" + extList[i];
-					if(Utils::FileSystem::exists(path))
-						thumbnail = path;
-				}
-			}
-		}
+			thumbnail = getLocalArtPath(LOCAL_ART_IMAGE_PNG | LOCAL_ART_IMAGE_JPG);
 	}
 
 	return thumbnail;
@@ -93,24 +85,80 @@ const std::string& FileData::getSortName()
 		return metadata.get("sortname");
 }
 
-const std::vector<FileData*>& FileData::getChildrenListToDisplay() {
+const std::vector<FileData*>& FileData::getChildrenListToDisplay()
+{
+	updateChildrenListToDisplay();
+	return mShowsFiltered ? mFilteredChildren : mChildren;
+}
+
+unsigned int FileData::getDisplayGeneration()
+{
+	updateChildrenListToDisplay();
+	return mDisplayGeneration;
+}
 
+void FileData::updateChildrenListToDisplay()
+{
 	FileFilterIndex* idx = CollectionSystemManager::get()->getSystemToView(mSystem)->getIndex();
-	if (idx->isFiltered()) {
-		mFilteredChildren.clear();
-		for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
+	if(!idx->isFiltered())
+	{
+		if(mShowsFiltered)
 		{
-			if (idx->showFile((*it))) {
-				mFilteredChildren.push_back(*it);
-			}
+			mShowsFiltered = false;
+			mDisplayGeneration = ++sDisplayGeneration;
 		}
+		return;
+	}
 
-		return mFilteredChildren;
+	// the filtered list only changes with the children or with what the index lets through
+	if(mShowsFiltered && mFilteredIndex == idx && mFilteredGeneration == idx->getGeneration())
+		return;
+
+	std::vector<FileData*> filteredChildren;
+	for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
+	{
+		if(idx->showFile(*it))
+			filteredChildren.push_back(*it);
 	}
-	else
+
+	// the index changes with every game added or edited, most of the time it's the same list
+	if(!mShowsFiltered || filteredChildren != mFilteredChildren)
 	{
-		return mChildren;
+		mFilteredChildren.swap(filteredChildren);
+		mDisplayGeneration = ++sDisplayGeneration;
 	}
+
+	mShowsFiltered = true;
+	mFilteredIndex = idx;
+	mFilteredGeneration = idx->getGeneration();
+}
+
+void FileData::onChildrenChanged()
+{
+	mFilteredIndex = nullptr;
+	mDisplayGeneration = ++sDisplayGeneration;
+}
+
+int FileData::getFirstLetterPosition(unsigned char letter)
+{
+	const unsigned int generation = getDisplayGeneration();
+	if(mLetterPositions.empty() || mLetterPositionsGeneration != generation)
+	{
+		const std::vector<FileData*>& children = getChildrenListToDisplay();
+
+		mLetterPositions.assign(256, -1);
+		for(size_t i = 0; i < children.size(); i++)
+		{
+			const std::string& name = children[i]->getSortName();
+			const unsigned char first = name.empty() ? 0 : (unsigned char)toupper((unsigned char)name[0]);
+			if(mLetterPositions[first] == -1)
+				mLetterPositions[first] = (int)i;
+		}
+
+		mLetterPositionsGeneration = generation;
+	}
+
+	return mLetterPositions[letter];
 }
 
 const std::string FileData::getVideoPath() const
@@ -119,11 +167,7 @@ const std::string FileData::getVideoPath() const
 
 	// no video, try to use local video
 	if(video.empty() && Settings::getInstance()->getBool("LocalArt"))
-	{
-		std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-video.mp4";
-		if(Utils::FileSystem::exists(path))
-			video = path;
-	}
+		video = getLocalArtPath(LOCAL_ART_VIDEO_MP4);
 
 	return video;
 }
@@ -134,18 +178,7 @@ const std::string FileData::getMarqueePath() const
 
 	// no marquee, try to use local marquee
 	if(marquee.empty() && Settings::getInstance()->getBool("LocalArt"))
-	{
-		const char* extList[2] = { ".png", ".jpg" };
-		for(int i = 0; i < 2; i++)
-		{
-			if(marquee.empty())
-			{
-				std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-marquee" + extList[i];
-				if(Utils::FileSystem::exists(path))
-					marquee = path;
-			}
-		}
-	}
+		marquee = getLocalArtPath(LOCAL_ART_MARQUEE_PNG | LOCAL_ART_MARQUEE_JPG);
 
 	return marquee;
 }
@@ -156,22 +189,20 @@ const std::string FileData::getImagePath() const
 
 	// no image, try to use local image
 	if(image.empty())
-	{
-		const char* extList[2] = { ".png", ".jpg" };
-		for(int i = 0; i < 2; i++)
-		{
-			if(image.empty())
-			{
-				std::string path = mEnvData->mStartPath + "/images/" + getDisplayName() + "-image" + extList[i];
-				if(Utils::FileSystem::exists(path))
-					image = path;
-			}
-		}
-	}
+		image = getLocalArtPath(LOCAL_ART_IMAGE_PNG | LOCAL_ART_IMAGE_JPG);
 
 	return image;
 }
 
+std::string FileData::getLocalArtPath(unsigned int files) const
+{
+	// local art lives in the images folder of the system the game comes from, not the collection
+	SystemData* system = const_cast<FileData*>(this)->getSourceFileData()->getSystem();
+	const std::string& name = getDisplayName();
+
+	return system->getLocalArtPath(name, system->getLocalArt(name) & files);
+}
+
 std::vector<FileData*> FileData::getFilesRecursive(unsigned int typeMask, bool displayedOnly) const
 {
 	std::vector<FileData*> out;
@@ -199,16 +230,6 @@ std::string FileData::getKey() {
 	return getFileName();
 }
 
-const bool FileData::isArcadeAsset()
-{
-	const std::string stem = Utils::FileSystem::getStem(mPath);
-	return (
-		(mSystem && (mSystem->hasPlatformId(PlatformIds::ARCADE) || mSystem->hasPlatformId(PlatformIds::NEOGEO)))
-		&&
-		(MameNames::getInstance()->isBios(stem) || MameNames::getInstance()->isDevice(stem))
-	);
-}
-
 FileData* FileData::getSourceFileData()
 {
 	return this;
@@ -225,6 +246,8 @@ void FileData::addChild(FileData* file)
 		mChildrenByFilename[key] = file;
 		mChildren.push_back(file);
 		file->mParent = this;
+		onChildrenChanged();
+		mSystem->addToPathIndex(file);
 	}
 }
 
@@ -233,12 +256,14 @@ void FileData::removeChild(FileData* file)
 	assert(mType == FOLDER);
 	assert(file->getParent() == this);
 	mChildrenByFilename.erase(file->getKey());
+	mSystem->removeFromPathIndex(file);
 	for(auto it = mChildren.cbegin(); it != mChildren.cend(); it++)
 	{
 		if(*it == file)
 		{
 			file->mParent = NULL;
 			mChildren.erase(it);
+			onChildrenChanged();
 			return;
 		}
 	}
@@ -250,6 +275,9 @@ void FileData::removeChild(FileData* file)
 
 void FileData::sort(ComparisonFunction& comparator, bool ascending)
 {
+	// re-sorting to the same order leaves the views of this folder as they are
+	const std::vector<FileData*> previous = mChildren;
+
 	if (ascending)
 	{
 		std::stable_sort(mChildren.begin(), mChildren.end(), comparator);
@@ -268,6 +296,9 @@ void FileData::sort(ComparisonFunction& comparator, bool ascending)
 				(*it)->sort(comparator, ascending);
 		}
 	}
+
+	if (mChildren != previous)
+		onChildrenChanged();
 }
 
 void FileData::sort(const SortType& type)
@@ -288,7 +319,7 @@ void FileData::launchGame(Window* window)
 	std::string command = mEnvData->mLaunchCommand;
 
 	const std::string rom      = Utils::FileSystem::getEscapedPath(getPath());
-	const std::string basename = Utils::FileSystem::getStem(getPath());
+	const std::string basename = mStem;
 	const std::string rom_raw  = Utils::FileSystem::getPreferredPath(getPath());
 	const std::string name     = getName();
 
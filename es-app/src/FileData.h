@@ -4,8 +4,10 @@
 
 #include "utils/FileSystemUtil.h"
 #include "MetaData.h"
+#include <atomic>
 #include <unordered_map>
 
+class FileFilterIndex;
 class SystemData;
 class Window;
 struct SystemEnvironmentData;
@@ -51,6 +53,10 @@ public:
 	virtual const std::string getImagePath() const;
 
 	const std::vector<FileData*>& getChildrenListToDisplay();
+	// changes whenever getChildrenListToDisplay() would return a different list, so views can skip repopulating
+	unsigned int getDisplayGeneration();
+	// position in getChildrenListToDisplay() of the first child whose sort name starts with letter (upper case), -1 if none
+	int getFirstLetterPosition(unsigned char letter);
 	std::vector<FileData*> getFilesRecursive(unsigned int typeMask, bool displayedOnly = false) const;
 
 	void addChild(FileData* file); // Error if mType != FOLDER
@@ -61,14 +67,14 @@ public:
 	virtual inline void refreshMetadata() { return; };
 
 	virtual std::string getKey();
-	const bool isArcadeAsset();
+	inline const bool isArcadeAsset() const { return mArcadeAsset; }
 	inline std::string getFullPath() { return getPath(); };
 	inline std::string getFileName() { return Utils::FileSystem::getFileName(getPath()); };
 	virtual FileData* getSourceFileData();
 	inline std::string getSystemName() const { return mSystemName; };
 
 	// Returns our best guess at the "real" name for this file (will attempt to perform MAME name translation)
-	std::string getDisplayName() const;
+	inline const std::string& getDisplayName() const { return mDisplayName ? *mDisplayName : mStem; }
 
 	// As above, but also remove parenthesis
 	std::string getCleanName() const;
@@ -97,13 +103,31 @@ protected:
 
 private:
 	void sort(ComparisonFunction& comparator, bool ascending = true);
+	void updateChildrenListToDisplay();
+	void onChildrenChanged();
+	// path of the first of the LocalArtFile files found in the images folder, empty if none
+	std::string getLocalArtPath(unsigned int files) const;
 	FileType mType;
 	std::string mPath;
+	// computed once when the file is created, the display name of an arcade game points into MameNames
+	std::string mStem;
+	const std::string* mDisplayName;
+	bool mArcadeAsset;
 	SystemEnvironmentData* mEnvData;
 	SystemData* mSystem;
 	std::unordered_map<std::string,FileData*> mChildrenByFilename;
 	std::vector<FileData*> mChildren;
+	// filtered children, kept until the children or the filter index in view change
 	std::vector<FileData*> mFilteredChildren;
+	const FileFilterIndex* mFilteredIndex;
+	unsigned int mFilteredGeneration;
+	bool mShowsFiltered;
+	// unique over all folders, a folder that replaces a deleted one never has the generation a view saw
+	unsigned int mDisplayGeneration;
+	static std::atomic<unsigned int> sDisplayGeneration; // systems are loaded in parallel
+	// first letter positions, built on first use for the current order and filter state
+	std::vector<int> mLetterPositions;
+	unsigned int mLetterPositionsGeneration;
 	std::string mSortDesc;
 };
 
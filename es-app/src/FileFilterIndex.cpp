@@ -10,7 +10,7 @@
 #define INCLUDE_UNKNOWN false;
 
 FileFilterIndex::FileFilterIndex()
-	: filterByFavorites(false), filterByGenre(false), filterByHidden(false), filterByKidGame(false), filterByPlayers(false), filterByPubDev(false), filterByRatings(false)
+	: filterByFavorites(false), filterByGenre(false), filterByHidden(false), filterByKidGame(false), filterByPlayers(false), filterByPubDev(false), filterByRatings(false), generation(0)
 {
 	clearAllFilters();
 	FilterDataDecl filterDecls[] = {
@@ -72,6 +72,8 @@ void FileFilterIndex::importIndex(FileFilterIndex* indexToImport)
 			}
 		}
 	}
+
+	searchIndex.import(indexToImport->searchIndex);
 }
 void FileFilterIndex::resetIndex()
 {
@@ -83,6 +85,7 @@ void FileFilterIndex::resetIndex()
 	clearIndex(favoritesIndexAllKeys);
 	clearIndex(hiddenIndexAllKeys);
 	clearIndex(kidGameIndexAllKeys);
+	searchIndex.clear();
 }
 
 std::string FileFilterIndex::getIndexableKey(FileData* game, FilterIndexType type, bool getSecondary)
@@ -191,6 +194,8 @@ void FileFilterIndex::addToIndex(FileData* game)
 	manageFavoritesEntryInIndex(game);
 	manageHiddenEntryInIndex(game);
 	manageKidGameEntryInIndex(game);
+	searchIndex.add(game);
+	generation++;
 }
 
 void FileFilterIndex::removeFromIndex(FileData* game)
@@ -202,6 +207,8 @@ void FileFilterIndex::removeFromIndex(FileData* game)
 	manageFavoritesEntryInIndex(game, true);
 	manageHiddenEntryInIndex(game, true);
 	manageKidGameEntryInIndex(game, true);
+	searchIndex.remove(game);
+	generation++;
 }
 
 void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>* values)
@@ -228,6 +235,7 @@ void FileFilterIndex::setFilter(FilterIndexType type, std::vector<std::string>*
 			}
 		}
 	}
+	generation++;
 	return;
 }
 
@@ -239,6 +247,7 @@ void FileFilterIndex::clearAllFilters()
 		*(filterData.filteredByRef) = false;
 		filterData.currentFilteredKeys->clear();
 	}
+	generation++;
 	return;
 }
 
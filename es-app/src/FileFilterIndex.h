@@ -2,6 +2,7 @@
 #ifndef ES_APP_FILE_FILTER_INDEX_H
 #define ES_APP_FILE_FILTER_INDEX_H
 
+#include "GameSearchIndex.h"
 #include <map>
 #include <vector>
 #include <string>
@@ -46,6 +47,9 @@ public:
 	bool isFiltered() { return (filterByGenre || filterByPlayers || filterByPubDev || filterByRatings || filterByFavorites || filterByHidden || filterByKidGame); };
 	bool isKeyBeingFilteredBy(std::string key, FilterIndexType type);
 	std::vector<FilterDataDecl>& getFilterDataDecls();
+	GameSearchIndex& getSearchIndex() { return searchIndex; };
+	// incremented whenever what showFile returns may have changed
+	unsigned int getGeneration() const { return generation; };
 
 	void importIndex(FileFilterIndex* indexToImport);
 	void resetIndex();
@@ -92,6 +96,9 @@ private:
 	std::vector<std::string> hiddenIndexFilteredKeys;
 	std::vector<std::string> kidGameIndexFilteredKeys;
 
+	GameSearchIndex searchIndex;
+	unsigned int generation;
+
 	FileData* mRootFolder;
 
 };
@@ -0,0 +1,286 @@
+#include "GameSearchIndex.h"
+
+#include "FileData.h"
+#include "Settings.h"
+#include <algorithm>
+
+// weight of developer and genre matches against title matches
+#define SEARCH_METADATA_WEIGHT 0.5f
+
+GameSearchIndex::GameSearchIndex() : mRemoved(0)
+{
+	mIncludeMetadata = Settings::getInstance()->getBool("SearchMetadata");
+}
+
+std::string GameSearchIndex::normalize(const std::string& text)
+{
+	std::string normalized;
+	normalized.reserve(text.length());
+
+	bool space = false;
+	for(size_t i = 0; i < text.length(); i++)
+	{
+		const unsigned char c = (unsigned char)text[i];
+
+		// bytes of multibyte characters are kept as they are
+		if((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c >= 0x80)
+		{
+			if(space && !normalized.empty())
+				normalized += ' ';
+			normalized += (char)c;
+			space = false;
+		}
+		else if(c >= 'A' && c <= 'Z')
+		{
+			if(space && !normalized.empty())
+				normalized += ' ';
+			normalized += (char)(c - 'A' + 'a');
+			space = false;
+		}
+		else if(c == '\'')
+		{
+			// "mario's" is searched as "marios"
+		}
+		else
+		{
+			space = true;
+		}
+	}
+
+	return normalized;
+}
+
+void GameSearchIndex::getTrigrams(const std::string& text, bool padEnd, std::vector<unsigned int>& trigrams_out)
+{
+	trigrams_out.clear();
+
+	size_t start = 0;
+	while(start < text.length())
+	{
+		size_t end = text.find(' ', start);
+		if(end == std::string::npos)
+			end = text.length();
+
+		// "  w", " wo", "wor", "ord", "rd ", the last word of a query that is still being typed has no end
+		unsigned int trigram = (unsigned int)' ' << 8 | ' ';
+		for(size_t i = start; i < end; i++)
+		{
+			trigram = ((trigram << 8) | (unsigned char)text[i]) & 0xFFFFFF;
+			trigrams_out.push_back(trigram);
+		}
+
+		if(padEnd || end < text.length())
+			trigrams_out.push_back(((trigram << 8) | ' ') & 0xFFFFFF);
+
+		start = end + 1;
+	}
+
+	std::sort(trigrams_out.begin(), trigrams_out.end());
+	trigrams_out.erase(std::unique(trigrams_out.begin(), trigrams_out.end()), trigrams_out.end());
+}
+
+void GameSearchIndex::add(FileData* game)
+{
+	if(mIds.find(game) != mIds.cend())
+		return;
+
+	std::string title = game->metadata.get("name");
+	const std::string& sortName = game->metadata.get("sortname");
+	if(!sortName.empty() && sortName != title)
+		title += " " + sortName;
+
+	std::vector<unsigned int> titleTrigrams;
+	getTrigrams(normalize(title), true, titleTrigrams);
+
+	std::vector<unsigned int> metaTrigrams;
+	if(mIncludeMetadata)
+		getTrigrams(normalize(game->metadata.get("developer") + " " + game->metadata.get("genre")), true, metaTrigrams);
+
+	addEntry(game, titleTrigrams, metaTrigrams);
+}
+
+void GameSearchIndex::addEntry(FileData* game, const std::vector<unsigned int>& title, const std::vector<unsigned int>& meta)
+{
+	const unsigned int id = (unsigned int)mEntries.size();
+
+	Entry entry;
+	entry.game = game;
+	entry.titleTrigrams = (unsigned short)std::min(title.size(), (size_t)0xFFFF);
+	entry.metaTrigrams = (unsigned short)std::min(meta.size(), (size_t)0xFFFF);
+	mEntries.push_back(entry);
+	mIds[game] = id;
+
+	for(auto it = title.cbegin(); it != title.cend(); it++)
+		mPostings[*it].push_back(id << 1);
+
+	for(auto it = meta.cbegin(); it != meta.cend(); it++)
+		mPostings[*it].push_back((id << 1) | 1);
+}
+
+void GameSearchIndex::remove(FileData* game)
+{
+	auto it = mIds.find(game);
+	if(it == mIds.cend())
+		return;
+
+	mEntries[it->second].game = nullptr;
+	mIds.erase(it);
+	mRemoved++;
+
+	if(mRemoved > mEntries.size() / 2)
+		compact();
+}
+
+void GameSearchIndex::compact()
+{
+	std::vector<unsigned int> newIds(mEntries.size());
+	std::vector<Entry> entries;
+	entries.reserve(mIds.size());
+
+	for(size_t i = 0; i < mEntries.size(); i++)
+	{
+		newIds[i] = (unsigned int)entries.size();
+		if(mEntries[i].game)
+		{
+			mIds[mEntries[i].game] = (unsigned int)entries.size();
+			entries.push_back(mEntries[i]);
+		}
+	}
+
+	// ids only ever shrink, so the posting lists stay sorted
+	auto it = mPostings.begin();
+	while(it != mPostings.end())
+	{
+		std::vector<unsigned int>& postings = it->second;
+		size_t kept = 0;
+		for(size_t i = 0; i < postings.size(); i++)
+		{
+			const unsigned int id = postings[i] >> 1;
+			if(mEntries[id].game)
+				postings[kept++] = (newIds[id] << 1) | (postings[i] & 1);
+		}
+
+		if(kept == 0)
+		{
+			it = mPostings.erase(it);
+			continue;
+		}
+
+		postings.resize(kept);
+		postings.shrink_to_fit();
+		it++;
+	}
+
+	mEntries.swap(entries);
+	mRemoved = 0;
+}
+
+void GameSearchIndex::clear()
+{
+	mEntries.clear();
+	mIds.clear();
+	mPostings.clear();
+	mRemoved = 0;
+}
+
+void GameSearchIndex::import(const GameSearchIndex& other)
+{
+	for(auto it = other.mEntries.cbegin(); it != other.mEntries.cend(); it++)
+	{
+		if(it->game)
+			add(it->game);
+	}
+}
+
+std::vector<GameSearchIndex::Result> GameSearchIndex::search(const std::string& query, size_t maxResults, const std::function<bool(FileData*)>& filter) const
+{
+	std::vector<Result> results;
+
+	std::vector<unsigned int> trigrams;
+	getTrigrams(normalize(query), false, trigrams);
+	if(trigrams.empty() || mIds.empty())
+		return results;
+
+	// trigrams each entry has in common with the query, for the title and the metadata
+	std::vector<unsigned short> titleHits(mEntries.size(), 0);
+	std::vector<unsigned short> metaHits(mIncludeMetadata ? mEntries.size() : 0, 0);
+	std::vector<unsigned int> candidates;
+
+	for(auto trigram = trigrams.cbegin(); trigram != trigrams.cend(); trigram++)
+	{
+		auto postings = mPostings.find(*trigram);
+		if(postings == mPostings.cend())
+			continue;
+
+		for(auto it = postings->second.cbegin(); it != postings->second.cend(); it++)
+		{
+			const unsigned int id = *it >> 1;
+			if(titleHits[id] == 0 && (metaHits.empty() || metaHits[id] == 0))
+				candidates.push_back(id);
+
+			if(*it & 1)
+				metaHits[id]++;
+			else
+				titleHits[id]++;
+		}
+	}
+
+	// at least half of what was typed has to match, anything less is noise
+	const unsigned int queryTrigrams = (unsigned int)trigrams.size();
+	const unsigned int minHits = (queryTrigrams + 1) / 2;
+
+	for(auto it = candidates.cbegin(); it != candidates.cend(); it++)
+	{
+		const Entry& entry = mEntries[*it];
+		if(!entry.game)
+			continue;
+
+		const unsigned int title = titleHits[*it];
+		const unsigned int meta = metaHits.empty() ? 0 : metaHits[*it];
+		if(title < minHits && meta < minHits)
+			continue;
+
+		if(filter && !filter(entry.game))
+			continue;
+
+		// shared trigrams over all trigrams of both, so shorter titles that match rank higher
+		float score = (float)title / (float)(queryTrigrams + entry.titleTrigrams - title);
+		if(meta > 0)
+			score = std::max(score, SEARCH_METADATA_WEIGHT * (float)meta / (float)(queryTrigrams + entry.metaTrigrams - meta));
+
+		Result result;
+		result.game = entry.game;
+		result.score = score;
+		results.push_back(result);
+	}
+
+	const auto compare = [](const Result& a, const Result& b)
+	{
+		if(a.score != b.score)
+			return a.score > b.score;
+		return a.game->getSortName() < b.game->getSortName();
+	};
+
+	if(results.size() > maxResults)
+	{
+		std::nth_element(results.begin(), results.begin() + maxResults, results.end(), compare);
+		results.resize(maxResults);
+	}
+
+	std::sort(results.begin(), results.end(), compare);
+	return results;
+}
+
+size_t GameSearchIndex::getMemoryUsage() const
+{
+	size_t size = mEntries.capacity() * sizeof(Entry);
+
+	// node and bucket of every map entry
+	size += mIds.size() * (sizeof(FileData*) + sizeof(unsigned int) + 2 * sizeof(void*)) + mIds.bucket_count() * sizeof(void*);
+	size += mPostings.size() * (sizeof(unsigned int) + sizeof(std::vector<unsigned int>) + 2 * sizeof(void*)) + mPostings.bucket_count() * sizeof(void*);
+
+	for(auto it = mPostings.cbegin(); it != mPostings.cend(); it++)
+		size += it->second.capacity() * sizeof(unsigned int);
+
+	return size;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef ES_APP_GAME_SEARCH_INDEX_H
+#define ES_APP_GAME_SEARCH_INDEX_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileData;
+
+// Trigram index of the games of a system, kept up to date by FileFilterIndex as games are
+// added and removed. Titles (name and sortname) are indexed, and developer and genre too when
+// "SearchMetadata" is set. Queries are ranked by the share of trigrams they have in common with
+// a game, so typos and partial words still find it. Removed games are only dropped from the
+// posting lists once they make up half of the index.
+class GameSearchIndex
+{
+public:
+	struct Result
+	{
+		FileData* game;
+		float     score; // 0 to 1, 1 being an exact title match
+	};
+
+	GameSearchIndex();
+
+	void add(FileData* game);
+	void remove(FileData* game);
+	void clear();
+
+	// adds the games of another index, used by the custom collections bundle
+	void import(const GameSearchIndex& other);
+
+	// best matches first, the last word of query may be incomplete. Games filter returns false
+	// for are left out before the results are cut to maxResults
+	std::vector<Result> search(const std::string& query, size_t maxResults, const std::function<bool(FileData*)>& filter = nullptr) const;
+
+	size_t size() const { return mIds.size(); }
+	size_t getTrigramCount() const { return mPostings.size(); }
+	size_t getMemoryUsage() const; // approximate, in bytes
+
+	// lowercase, words separated by a single space
+	static std::string normalize(const std::string& text);
+
+private:
+	struct Entry
+	{
+		FileData*      game; // nullptr once removed
+		unsigned short titleTrigrams;
+		unsigned short metaTrigrams;
+	};
+
+	void addEntry(FileData* game, const std::vector<unsigned int>& title, const std::vector<unsigned int>& meta);
+	void compact();
+
+	// unique trigrams of normalized text, every word is padded so short words and word starts match
+	static void getTrigrams(const std::string& text, bool padEnd, std::vector<unsigned int>& trigrams_out);
+
+	std::vector<Entry> mEntries;
+	std::unordered_map<FileData*, unsigned int> mIds;
+	// trigram to entry ids, shifted left by one, the low bit set for developer and genre trigrams
+	std::unordered_map<unsigned int, std::vector<unsigned int>> mPostings;
+	unsigned int mRemoved;
+	bool mIncludeMetadata;
+};
+
+#endif // ES_APP_GAME_SEARCH_INDEX_H
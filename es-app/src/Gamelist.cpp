@@ -3,8 +3,10 @@
 #include <chrono>
 
 #include "utils/FileSystemUtil.h"
+#include "utils/TracingUtil.h"
 #include "FileData.h"
 #include "FileFilterIndex.h"
+#include "GamelistReader.h"
 #include "Log.h"
 #include "Settings.h"
 #include "SystemData.h"
@@ -12,6 +14,11 @@
 
 FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType type)
 {
+	// files found by populateFolder and those created for earlier entries are indexed by path
+	FileData* indexed = system->getFileByPath(path);
+	if(indexed != nullptr)
+		return indexed;
+
 	FileData* root = system->getRootFolder();
 	bool contains = false;
 	const std::string systemPath = root->getPath();
@@ -101,78 +108,80 @@ FileData* findOrCreateFile(SystemData* system, const std::string& path, FileType
 	return NULL;
 }
 
-void parseGamelist(SystemData* system)
+static void loadGamelistEntry(SystemData* system, const GamelistReader::Entry& entry, const std::string& relativeTo, bool trustGamelist)
 {
-	bool trustGamelist = Settings::getInstance()->getBool("ParseGamelistOnly");
-	std::string xmlpath = system->getGamelistPath(false);
-	const std::vector<std::string> allowedExtensions = system->getExtensions();
+	const std::string* pathField = entry.get("path");
+	const std::string path = Utils::FileSystem::resolveRelativePath(pathField ? *pathField : "", relativeTo, false, true);
 
-	if(!Utils::FileSystem::exists(xmlpath))
+	if(!trustGamelist && !Utils::FileSystem::exists(path))
+	{
+		LOG(LogWarning) << "File \"" << path << "\" does not exist! Ignoring.";
 		return;
+	}
 
-	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
-
-	pugi::xml_document doc;
-	pugi::xml_parse_result result = doc.load_file(xmlpath.c_str());
-
-	if(!result)
+	// Check whether the file's extension is allowed in the system
+	if(entry.type == GAME && !system->hasExtension(Utils::FileSystem::getExtension(path)))
 	{
-		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << result.description();
+		LOG(LogDebug) << "file " << path << " found in gamelist, but has unregistered extension";
 		return;
 	}
 
-	pugi::xml_node root = doc.child("gameList");
-	if(!root)
+	FileData* file = findOrCreateFile(system, path, entry.type);
+	if(!file)
 	{
-		LOG(LogError) << "Could not find <gameList> node in gamelist \"" << xmlpath << "\"!";
+		LOG(LogError) << "Error finding/creating FileData for \"" << path << "\", skipping.";
 		return;
 	}
+	else if(!file->isArcadeAsset())
+	{
+		std::string defaultName = file->metadata.get("name");
+		file->metadata = MetaDataList::createFromFields(file->getType() == GAME ? GAME_METADATA : FOLDER_METADATA, entry.fields, entry.fieldCount, relativeTo);
 
-	std::string relativeTo = system->getStartPath();
+		//make sure name gets set if one didn't exist
+		if(file->metadata.get("name").empty())
+			file->metadata.set("name", defaultName);
 
-	const char* tagList[2] = { "game", "folder" };
-	FileType typeList[2] = { GAME, FOLDER };
-	for(int i = 0; i < 2; i++)
-	{
-		const char* tag = tagList[i];
-		FileType type = typeList[i];
-		for(pugi::xml_node fileNode = root.child(tag); fileNode; fileNode = fileNode.next_sibling(tag))
-		{
-			std::string path = fileNode.child("path").text().get();
-			path = Utils::FileSystem::resolveRelativePath(path, relativeTo, false, true);
+		file->metadata.resetChangedFlag();
+	}
+}
 
-			if(!trustGamelist && !Utils::FileSystem::exists(path))
-			{
-				LOG(LogWarning) << "File \"" << path << "\" does not exist! Ignoring.";
-				continue;
-			}
+void parseGamelist(SystemData* system)
+{
+	TraceScopeArg("parseGamelist", system->getName());
+	bool trustGamelist = Settings::getInstance()->getBool("ParseGamelistOnly");
+	std::string xmlpath = system->getGamelistPath(false);
 
-			// Check whether the file's extension is allowed in the system
-			if (i == 0 /*game*/ && std::find(allowedExtensions.cbegin(), allowedExtensions.cend(), Utils::FileSystem::getExtension(path)) == allowedExtensions.cend())
-			{
-				LOG(LogDebug) << "file " << path << " found in gamelist, but has unregistered extension";
-				continue;
-			}
+	if(!Utils::FileSystem::exists(xmlpath))
+		return;
 
-			FileData* file = findOrCreateFile(system, path, type);
-			if(!file)
-			{
-				LOG(LogError) << "Error finding/creating FileData for \"" << path << "\", skipping.";
-				continue;
-			}
-			else if(!file->isArcadeAsset())
-			{
-				std::string defaultName = file->metadata.get("name");
-				file->metadata = MetaDataList::createFromXML(file->getType() == GAME ? GAME_METADATA : FOLDER_METADATA, fileNode, relativeTo);
+	LOG(LogInfo) << "Parsing XML file \"" << xmlpath << "\"...";
 
-				//make sure name gets set if one didn't exist
-				if(file->metadata.get("name").empty())
-					file->metadata.set("name", defaultName);
+	GamelistReader reader(xmlpath);
+	if(!reader.isOpen())
+	{
+		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	Could not open file";
+		return;
+	}
 
-				file->metadata.resetChangedFlag();
-			}
-		}
+	std::string relativeTo = system->getStartPath();
+
+	// the gamelist is read in a single pass, games are loaded as they are read.
+	// folders are loaded after all games, they might only exist once their games were added
+	GamelistReader::Entry entry;
+	std::vector<GamelistReader::Entry> folders;
+	while(reader.next(entry))
+	{
+		if(entry.type == FOLDER)
+			folders.push_back(entry);
+		else
+			loadGamelistEntry(system, entry, relativeTo, trustGamelist);
 	}
+
+	if(!reader.getError().empty())
+		LOG(LogError) << "Error parsing XML file \"" << xmlpath << "\"!\n	" << reader.getError();
+
+	for(auto it = folders.cbegin(); it != folders.cend(); it++)
+		loadGamelistEntry(system, *it, relativeTo, trustGamelist);
 }
 
 void addFileDataNode(pugi::xml_node& parent, const FileData* file, const char* tag, SystemData* system)
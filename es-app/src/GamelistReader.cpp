@@ -0,0 +1,440 @@
+#include "GamelistReader.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GAMELIST_READER_BUFFER_SIZE (64 * 1024)
+// longest entity we decode, "&#x10FFFF;" without the '&'
+#define GAMELIST_READER_MAX_ENTITY 9
+
+static void appendUTF8(std::string& str, unsigned int c)
+{
+	if(c < 0x80)
+	{
+		str += (char)c;
+	}
+	else if(c < 0x800)
+	{
+		str += (char)(0xC0 | (c >> 6));
+		str += (char)(0x80 | (c & 0x3F));
+	}
+	else if(c < 0x10000)
+	{
+		str += (char)(0xE0 | (c >> 12));
+		str += (char)(0x80 | ((c >> 6) & 0x3F));
+		str += (char)(0x80 | (c & 0x3F));
+	}
+	else if(c < 0x110000)
+	{
+		str += (char)(0xF0 | (c >> 18));
+		str += (char)(0x80 | ((c >> 12) & 0x3F));
+		str += (char)(0x80 | ((c >> 6) & 0x3F));
+		str += (char)(0x80 | (c & 0x3F));
+	}
+}
+
+static inline bool isSpace(int c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const std::string* GamelistReader::Entry::get(const std::string& key) const
+{
+	for(size_t i = 0; i < fieldCount; i++)
+	{
+		if(fields[i].first == key)
+			return &fields[i].second;
+	}
+
+	return nullptr;
+}
+
+GamelistReader::GamelistReader(const std::string& path) : mStream(path, std::ios::binary), mBuffer(GAMELIST_READER_BUFFER_SIZE), mPos(0), mEnd(0), mInEntry(false), mDone(false)
+{
+	// skip the utf-8 byte order mark
+	if(fill() && mEnd >= 3 && memcmp(mBuffer.data(), "\xEF\xBB\xBF", 3) == 0)
+		mPos = 3;
+}
+
+bool GamelistReader::fill()
+{
+	if(!mStream.is_open() || mStream.eof())
+		return false;
+
+	mStream.read(mBuffer.data(), mBuffer.size());
+	mPos = 0;
+	mEnd = (size_t)mStream.gcount();
+	return mEnd > 0;
+}
+
+bool GamelistReader::setError(const std::string& error)
+{
+	mError = error;
+	mDone = true;
+	return false;
+}
+
+bool GamelistReader::next(Entry& entry_out)
+{
+	while(!mDone)
+	{
+		const Token token = readToken();
+		switch(token)
+		{
+		case TOKEN_ERROR:
+			return false;
+
+		case TOKEN_EOF:
+			return setError(mOpen.empty() ? "Could not find <gameList> node" : "Unexpected end of file in <" + mOpen.back() + ">");
+
+		case TOKEN_TEXT:
+			// only the text directly inside the child elements of an entry is kept
+			if(mInEntry && mOpen.size() == 3)
+				entry_out.fields[entry_out.fieldCount - 1].second += mText;
+			break;
+
+		case TOKEN_START:
+		case TOKEN_EMPTY:
+			if(mOpen.empty())
+			{
+				if(mName != "gameList")
+					return setError("Could not find <gameList> node");
+
+				if(token == TOKEN_EMPTY)
+				{
+					mDone = true;
+					return false;
+				}
+			}
+			else if(mOpen.size() == 1 && (mName == "game" || mName == "folder"))
+			{
+				entry_out.type = mName == "game" ? GAME : FOLDER;
+				entry_out.fieldCount = 0;
+
+				if(token == TOKEN_EMPTY)
+					return true;
+
+				mInEntry = true;
+			}
+			else if(mOpen.size() == 2 && mInEntry)
+			{
+				if(entry_out.fieldCount == entry_out.fields.size())
+					entry_out.fields.push_back(std::pair<std::string, std::string>());
+
+				std::pair<std::string, std::string>& field = entry_out.fields[entry_out.fieldCount++];
+				field.first = mName;
+				field.second.clear();
+			}
+
+			if(token == TOKEN_START)
+				mOpen.push_back(mName);
+			break;
+
+		case TOKEN_END:
+			if(mOpen.empty() || mOpen.back() != mName)
+				return setError("Unexpected end tag </" + mName + ">");
+
+			mOpen.pop_back();
+
+			if(mOpen.size() == 1 && mInEntry)
+			{
+				mInEntry = false;
+				return true;
+			}
+
+			// end of the gameList, whatever follows is ignored
+			if(mOpen.empty())
+				mDone = true;
+			break;
+		}
+	}
+
+	return false;
+}
+
+GamelistReader::Token GamelistReader::readToken()
+{
+	while(true)
+	{
+		int c = peek();
+		if(c == -1)
+			return TOKEN_EOF;
+
+		if(c != '<')
+		{
+			if(!readText())
+				return TOKEN_ERROR;
+			return TOKEN_TEXT;
+		}
+
+		get();
+		c = get();
+
+		// processing instruction, including the xml declaration
+		if(c == '?')
+		{
+			if(!skipUntil("?>"))
+				return TOKEN_ERROR;
+			continue;
+		}
+
+		if(c == '!')
+		{
+			c = get();
+			if(c == '-')
+			{
+				if(get() != '-' || !skipUntil("-->"))
+				{
+					setError("Invalid comment");
+					return TOKEN_ERROR;
+				}
+				continue;
+			}
+
+			if(c == '[')
+			{
+				for(const char* cdata = "CDATA["; *cdata; cdata++)
+				{
+					if(get() != *cdata)
+					{
+						setError("Invalid CDATA section");
+						return TOKEN_ERROR;
+					}
+				}
+
+				if(!readCData())
+					return TOKEN_ERROR;
+				return TOKEN_TEXT;
+			}
+
+			// doctype, skip it along with its internal subset
+			int depth = 0;
+			while(c != -1 && (c != '>' || depth > 0))
+			{
+				if(c == '[')      depth++;
+				else if(c == ']') depth--;
+				c = get();
+			}
+
+			if(c == -1)
+			{
+				setError("Invalid document type declaration");
+				return TOKEN_ERROR;
+			}
+			continue;
+		}
+
+		if(c == '/')
+		{
+			if(!readName(mName))
+				return TOKEN_ERROR;
+
+			while(isSpace(peek()))
+				get();
+
+			if(get() != '>')
+			{
+				setError("Invalid end tag </" + mName + ">");
+				return TOKEN_ERROR;
+			}
+			return TOKEN_END;
+		}
+
+		// start tag, give the character back to the name
+		mPos--;
+
+		bool empty = false;
+		if(!readName(mName) || !skipAttributes(empty))
+			return TOKEN_ERROR;
+
+		return empty ? TOKEN_EMPTY : TOKEN_START;
+	}
+}
+
+bool GamelistReader::readName(std::string& name_out)
+{
+	name_out.clear();
+
+	int c = peek();
+	while(c != -1 && !isSpace(c) && c != '/' && c != '>' && c != '=' && c != '<')
+	{
+		name_out += (char)get();
+		c = peek();
+	}
+
+	if(name_out.empty())
+		return setError("Invalid element name");
+
+	return true;
+}
+
+bool GamelistReader::skipAttributes(bool& empty_out)
+{
+	while(true)
+	{
+		int c = get();
+		while(isSpace(c))
+			c = get();
+
+		if(c == '>')
+			return true;
+
+		if(c == '/')
+		{
+			if(get() != '>')
+				return setError("Invalid element <" + mName + ">");
+
+			empty_out = true;
+			return true;
+		}
+
+		// name="value" or name='value'
+		while(c != -1 && c != '=' && c != '>')
+			c = get();
+
+		if(c != '=')
+			return setError("Invalid attribute in <" + mName + ">");
+
+		c = get();
+		while(isSpace(c))
+			c = get();
+
+		if(c != '"' && c != '\'')
+			return setError("Invalid attribute in <" + mName + ">");
+
+		const int quote = c;
+		do
+		{
+			c = get();
+		} while(c != -1 && c != quote);
+
+		if(c == -1)
+			return setError("Invalid attribute in <" + mName + ">");
+	}
+}
+
+bool GamelistReader::readText()
+{
+	mText.clear();
+
+	// copy runs of plain characters at once, only entities and line ends need work
+	while(mPos < mEnd || fill())
+	{
+		const size_t start = mPos;
+		while(mPos < mEnd && mBuffer[mPos] != '<' && mBuffer[mPos] != '&' && mBuffer[mPos] != '\r')
+			mPos++;
+
+		mText.append(mBuffer.data() + start, mPos - start);
+
+		if(mPos == mEnd)
+			continue;
+
+		const char c = mBuffer[mPos];
+		if(c == '<')
+			break;
+
+		mPos++;
+		if(c == '&')
+		{
+			appendEntity();
+		}
+		else
+		{
+			// line ends are normalized to \n
+			mText += '\n';
+			if(peek() == '\n')
+				get();
+		}
+	}
+
+	// text made only of whitespace is formatting, not content
+	for(size_t i = 0; i < mText.size(); i++)
+	{
+		if(!isSpace(mText[i]))
+			return true;
+	}
+
+	mText.clear();
+	return true;
+}
+
+bool GamelistReader::readCData()
+{
+	mText.clear();
+
+	int c = get();
+	while(c != -1)
+	{
+		mText += (char)c;
+		if(c == '>' && mText.size() >= 3 && mText.compare(mText.size() - 3, 3, "]]>") == 0)
+		{
+			mText.resize(mText.size() - 3);
+			return true;
+		}
+		c = get();
+	}
+
+	return setError("Unterminated CDATA section");
+}
+
+bool GamelistReader::skipUntil(const char* terminator)
+{
+	const size_t length = strlen(terminator);
+	std::string last;
+
+	int c = get();
+	while(c != -1)
+	{
+		last += (char)c;
+		if(last.size() > length)
+			last.erase(0, 1);
+
+		if(last == terminator)
+			return true;
+
+		c = get();
+	}
+
+	return setError(std::string("Missing ") + terminator);
+}
+
+void GamelistReader::appendEntity()
+{
+	std::string name;
+
+	int c = peek();
+	while(c != -1 && c != ';' && name.size() < GAMELIST_READER_MAX_ENTITY && (isalnum(c) || c == '#'))
+	{
+		name += (char)get();
+		c = peek();
+	}
+
+	// not an entity, keep it as it was written
+	if(c != ';')
+	{
+		mText += '&';
+		mText += name;
+		return;
+	}
+	get();
+
+	if(name == "amp")       mText += '&';
+	else if(name == "lt")   mText += '<';
+	else if(name == "gt")   mText += '>';
+	else if(name == "quot") mText += '"';
+	else if(name == "apos") mText += '\'';
+	else if(name.size() > 1 && name[0] == '#')
+	{
+		char* end = nullptr;
+		const unsigned long code = (name[1] == 'x') ? strtoul(name.c_str() + 2, &end, 16) : strtoul(name.c_str() + 1, &end, 10);
+		if(end != nullptr && *end == '\0' && code > 0)
+			appendUTF8(mText, (unsigned int)code);
+		else
+			mText += "&" + name + ";";
+	}
+	else
+	{
+		mText += "&" + name + ";";
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef ES_APP_GAMELIST_READER_H
+#define ES_APP_GAMELIST_READER_H
+
+#include "FileData.h"
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Reads the <game> and <folder> entries of a gamelist.xml one at a time, straight from
+// the file, so loading a large gamelist doesn't need the whole document in memory.
+// Only what the gamelist uses is understood: the text of the elements directly below an
+// entry, with entities, CDATA sections and comments. Attributes are skipped.
+class GamelistReader
+{
+public:
+	struct Entry
+	{
+		FileType type;
+		// the child elements of the entry as key, text; only the first fieldCount are valid,
+		// the rest are kept so their strings can be reused by the next entry
+		std::vector<std::pair<std::string, std::string>> fields;
+		size_t fieldCount;
+
+		Entry() : type(GAME), fieldCount(0) { }
+		const std::string* get(const std::string& key) const;
+	};
+
+	GamelistReader(const std::string& path);
+
+	bool isOpen() const { return mStream.is_open(); }
+
+	// reads the next entry, returns false at the end of the gameList or on an error
+	bool next(Entry& entry_out);
+
+	// empty unless the file could not be read up to the end of the gameList
+	const std::string& getError() const { return mError; }
+
+private:
+	enum Token
+	{
+		TOKEN_START,
+		TOKEN_EMPTY, // self closing element
+		TOKEN_END,
+		TOKEN_TEXT,
+		TOKEN_EOF,
+		TOKEN_ERROR
+	};
+
+	Token readToken();
+	bool readName(std::string& name_out);
+	bool readText();
+	bool readCData();
+	bool skipUntil(const char* terminator);
+	bool skipAttributes(bool& empty_out);
+	void appendEntity();
+	bool setError(const std::string& error);
+
+	inline int peek()
+	{
+		if(mPos == mEnd && !fill())
+			return -1;
+		return (unsigned char)mBuffer[mPos];
+	}
+
+	inline int get()
+	{
+		if(mPos == mEnd && !fill())
+			return -1;
+		return (unsigned char)mBuffer[mPos++];
+	}
+
+	bool fill();
+
+	std::ifstream            mStream;
+	std::vector<char>        mBuffer;
+	size_t                   mPos;
+	size_t                   mEnd;
+	std::string              mError;
+
+	std::vector<std::string> mOpen;    // names of the elements we are in
+	std::string              mName;    // name of the last start or end tag
+	std::string              mText;    // text of the last text token
+	bool                     mInEntry;
+	bool                     mDone;
+};
+
+#endif // ES_APP_GAMELIST_READER_H
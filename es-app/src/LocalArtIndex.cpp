@@ -0,0 +1,199 @@
+#include "LocalArtIndex.h"
+
+#include "utils/FileSystemUtil.h"
+#include <SDL_timer.h>
+#include <string.h>
+#if defined(__linux__)
+#include <map>
+#include <mutex>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+// lookups happen on every cursor move, don't look for changes more often than this
+#define LOCAL_ART_CHECK_MS 1000
+
+#if defined(__linux__)
+// one inotify instance for all systems, the watch descriptors tell their folders apart. Systems
+// are loaded on several threads, the mutex also guards mWatch and mChanged of every index
+static int sNotify = -1;
+static std::map<int, LocalArtIndex*> sWatches;
+static std::mutex sNotifyMutex;
+#endif // __linux__
+
+static const struct { unsigned int file; const char* suffix; } sLocalArtSuffixes[] =
+{
+	{ LOCAL_ART_IMAGE_PNG,   "-image.png"   },
+	{ LOCAL_ART_IMAGE_JPG,   "-image.jpg"   },
+	{ LOCAL_ART_VIDEO_MP4,   "-video.mp4"   },
+	{ LOCAL_ART_MARQUEE_PNG, "-marquee.png" },
+	{ LOCAL_ART_MARQUEE_JPG, "-marquee.jpg" }
+};
+
+LocalArtIndex::LocalArtIndex(const std::string& path) : mPath(path), mLoaded(false), mGeneration(0), mLastCheck(0), mModified(0), mWatch(-1), mChanged(false)
+{
+}
+
+LocalArtIndex::~LocalArtIndex()
+{
+#if defined(__linux__)
+	std::unique_lock<std::mutex> lock(sNotifyMutex);
+
+	if(mWatch != -1)
+	{
+		inotify_rm_watch(sNotify, mWatch);
+		sWatches.erase(mWatch);
+	}
+
+	if(sWatches.empty() && sNotify != -1)
+	{
+		close(sNotify);
+		sNotify = -1;
+	}
+#endif // __linux__
+}
+
+void LocalArtIndex::pollChanges()
+{
+#if defined(__linux__)
+	std::unique_lock<std::mutex> lock(sNotifyMutex);
+
+	if(sNotify == -1)
+		return;
+
+	// only which folder changed matters, the index lists it again the next time it is used
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	ssize_t length;
+	while((length = read(sNotify, buffer, sizeof(buffer))) > 0)
+	{
+		for(char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)ptr;
+			auto it = sWatches.find(event->wd);
+			if(it == sWatches.cend())
+				continue;
+
+			it->second->mChanged = true;
+
+			// the folder itself is gone and so is its watch, it is watched again when listed
+			if(event->mask & IN_IGNORED)
+			{
+				it->second->mWatch = -1;
+				sWatches.erase(it);
+			}
+		}
+	}
+#endif // __linux__
+}
+
+unsigned int LocalArtIndex::get(const std::string& name)
+{
+	checkForChanges();
+
+	auto it = mFiles.find(name);
+	return (it != mFiles.cend()) ? it->second : 0;
+}
+
+unsigned int LocalArtIndex::getGeneration()
+{
+	checkForChanges();
+	return mGeneration;
+}
+
+std::string LocalArtIndex::getPath(const std::string& name, unsigned int files) const
+{
+	for(unsigned int i = 0; i < sizeof(sLocalArtSuffixes) / sizeof(sLocalArtSuffixes[0]); ++i)
+	{
+		if(files & sLocalArtSuffixes[i].file)
+			return mPath + "/" + name + sLocalArtSuffixes[i].suffix;
+	}
+
+	return "";
+}
+
+void LocalArtIndex::load()
+{
+#if defined(__linux__)
+	{
+		// watch before listing so nothing created in between is missed
+		std::unique_lock<std::mutex> lock(sNotifyMutex);
+
+		if(sNotify == -1)
+			sNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if(mWatch == -1 && sNotify != -1)
+		{
+			// fails when there is no images folder (yet), its modification time is used then
+			mWatch = inotify_add_watch(sNotify, mPath.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+			if(mWatch != -1)
+				sWatches[mWatch] = this;
+		}
+
+		mChanged = false;
+	}
+#else
+	mChanged = false;
+#endif // __linux__
+
+	mLoaded = true;
+	mGeneration++;
+	mLastCheck = SDL_GetTicks();
+	mModified = Utils::FileSystem::getModificationTime(mPath);
+	mFiles.clear();
+
+	if(!Utils::FileSystem::isDirectory(mPath))
+		return;
+
+	Utils::FileSystem::stringList dirContent = Utils::FileSystem::getDirContent(mPath);
+	for(auto it = dirContent.cbegin(); it != dirContent.cend(); ++it)
+	{
+		const std::string fileName = Utils::FileSystem::getFileName(*it);
+		for(unsigned int i = 0; i < sizeof(sLocalArtSuffixes) / sizeof(sLocalArtSuffixes[0]); ++i)
+		{
+			const size_t suffixLength = strlen(sLocalArtSuffixes[i].suffix);
+			if(fileName.size() > suffixLength && fileName.compare(fileName.size() - suffixLength, suffixLength, sLocalArtSuffixes[i].suffix) == 0)
+			{
+				mFiles[fileName.substr(0, fileName.size() - suffixLength)] |= sLocalArtSuffixes[i].file;
+				break;
+			}
+		}
+	}
+}
+
+void LocalArtIndex::checkForChanges()
+{
+	if(!mLoaded)
+	{
+		load();
+		return;
+	}
+
+#if defined(__linux__)
+	bool watched;
+	bool changed;
+	{
+		std::unique_lock<std::mutex> lock(sNotifyMutex);
+		watched = (mWatch != -1);
+		changed = mChanged;
+	}
+
+	if(watched)
+	{
+		// pollChanges() flags the folder once a frame
+		if(changed)
+			load();
+		return;
+	}
+#else
+	const bool changed = mChanged;
+#endif // __linux__
+
+	const unsigned int now = SDL_GetTicks();
+	if(now - mLastCheck < LOCAL_ART_CHECK_MS)
+		return;
+
+	mLastCheck = now;
+
+	if(changed || Utils::FileSystem::getModificationTime(mPath) != mModified)
+		load();
+}
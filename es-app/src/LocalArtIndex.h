@@ -0,0 +1,54 @@
+#pragma once
+#ifndef ES_APP_LOCAL_ART_INDEX_H
+#define ES_APP_LOCAL_ART_INDEX_H
+
+#include <string>
+#include <unordered_map>
+
+// Local art files for a game, in the order the FileData getters prefer them
+enum LocalArtFile : unsigned int
+{
+	LOCAL_ART_IMAGE_PNG   = 1,  // <name>-image.png
+	LOCAL_ART_IMAGE_JPG   = 2,  // <name>-image.jpg
+	LOCAL_ART_VIDEO_MP4   = 4,  // <name>-video.mp4
+	LOCAL_ART_MARQUEE_PNG = 8,  // <name>-marquee.png
+	LOCAL_ART_MARQUEE_JPG = 16  // <name>-marquee.jpg
+};
+
+// Index of the art in a system's images folder by game name, so finding local art for a game
+// is a hash lookup instead of a stat per candidate file. The folder is listed on first use and
+// listed again when it changes, which is watched with inotify on Linux and by the folder's
+// modification time elsewhere. All indexes share one inotify instance, read by pollChanges().
+class LocalArtIndex
+{
+public:
+	LocalArtIndex(const std::string& path);
+	~LocalArtIndex();
+
+	// returns the LocalArtFile flags of the files found for the game's display name
+	unsigned int get(const std::string& name);
+
+	// incremented every time the folder is listed again
+	unsigned int getGeneration();
+
+	// returns the path of the first file in files, which must not be empty
+	std::string getPath(const std::string& name, unsigned int files) const;
+
+	// reads the pending inotify events of all indexes, called once per frame
+	static void pollChanges();
+
+private:
+	void load();
+	void checkForChanges();
+
+	std::string                                  mPath;
+	std::unordered_map<std::string, unsigned int> mFiles;
+	bool                                         mLoaded;
+	unsigned int                                 mGeneration;
+	unsigned int                                 mLastCheck;
+	long long                                    mModified;
+	int                                          mWatch; // inotify watch descriptor, -1 if the modification time is used
+	bool                                         mChanged; // set by pollChanges()
+};
+
+#endif // ES_APP_LOCAL_ART_INDEX_H
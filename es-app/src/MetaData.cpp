@@ -4,6 +4,7 @@
 #include "utils/TimeUtil.h"
 #include "Log.h"
 #include <pugixml.hpp>
+#include <unordered_map>
 
 MetaDataDecl gameDecls[] = {
 	// key,         type,                   default,            statistic,  name in GuiMetaDataEd,  prompt in GuiMetaDataEd
@@ -76,27 +77,52 @@ MetaDataList::MetaDataList(MetaDataListType type)
 }
 
 
-MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo)
+// maps the keys of a metadata type to their position in its declarations
+static std::unordered_map<std::string, size_t> createMDDSlots(MetaDataListType type)
+{
+	std::unordered_map<std::string, size_t> slots;
+
+	const std::vector<MetaDataDecl>& mdd = getMDDByType(type);
+	for(size_t i = 0; i < mdd.size(); i++)
+		slots[mdd[i].key] = i;
+
+	return slots;
+}
+
+static const std::unordered_map<std::string, size_t>& getMDDSlots(MetaDataListType type)
+{
+	static const std::unordered_map<std::string, size_t> gameSlots = createMDDSlots(GAME_METADATA);
+	static const std::unordered_map<std::string, size_t> folderSlots = createMDDSlots(FOLDER_METADATA);
+
+	return (type == FOLDER_METADATA) ? folderSlots : gameSlots;
+}
+
+MetaDataList MetaDataList::createFromFields(MetaDataListType type, const std::vector<std::pair<std::string, std::string>>& fields, size_t fieldCount, const std::string& relativeTo)
 {
 	MetaDataList mdl(type);
 
 	const std::vector<MetaDataDecl>& mdd = mdl.getMDD();
+	const std::unordered_map<std::string, size_t>& slots = getMDDSlots(type);
 
-	for(auto iter = mdd.cbegin(); iter != mdd.cend(); iter++)
+	// the first field with a key wins, like it did when the gamelist was read as a document
+	std::vector<const std::string*> values(mdd.size(), nullptr);
+	for(size_t i = 0; i < fieldCount; i++)
 	{
-		pugi::xml_node md = node.child(iter->key.c_str());
-		if(md)
-		{
-			// if it's a path, resolve relative paths
-			std::string value = md.text().get();
-			if (iter->type == MD_PATH)
-			{
-				value = Utils::FileSystem::resolveRelativePath(value, relativeTo, true, true);
-			}
-			mdl.set(iter->key, value);
-		}else{
-			mdl.set(iter->key, iter->defaultValue);
-		}
+		auto slot = slots.find(fields[i].first);
+		if(slot != slots.cend() && values[slot->second] == nullptr)
+			values[slot->second] = &fields[i].second;
+	}
+
+	for(size_t i = 0; i < mdd.size(); i++)
+	{
+		if(values[i] == nullptr)
+			continue;
+
+		// if it's a path, resolve relative paths
+		if(mdd[i].type == MD_PATH)
+			mdl.set(mdd[i].key, Utils::FileSystem::resolveRelativePath(*values[i], relativeTo, true, true));
+		else
+			mdl.set(mdd[i].key, *values[i]);
 	}
 
 	return mdl;
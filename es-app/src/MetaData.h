@@ -3,6 +3,7 @@
 #define ES_APP_META_DATA_H
 
 #include <map>
+#include <utility>
 #include <vector>
 #include <string>
 
@@ -45,7 +46,8 @@ const std::vector<MetaDataDecl>& getMDDByType(MetaDataListType type);
 class MetaDataList
 {
 public:
-	static MetaDataList createFromXML(MetaDataListType type, pugi::xml_node& node, const std::string& relativeTo);
+	// fields are the key, value pairs read from a gamelist entry, keys that aren't metadata are ignored
+	static MetaDataList createFromFields(MetaDataListType type, const std::vector<std::pair<std::string, std::string>>& fields, size_t fieldCount, const std::string& relativeTo);
 	void appendToXML(pugi::xml_node& parent, bool ignoreDefaults, const std::string& relativeTo) const;
 
 	MetaDataList(MetaDataListType type);
@@ -1,290 +1,233 @@
 #include "ScraperCmdLine.h"
 
+#include "scrapers/ScraperBatch.h"
+#include "utils/FileSystemUtil.h"
+#include "FileData.h"
+#include "HttpCache.h"
 #include "Log.h"
-#include "platform.h"
+#include "PlatformId.h"
 #include "SystemData.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <signal.h>
-#if defined(__linux__)
-#include <unistd.h>
-#elif defined(WIN32)
-#include <Windows.h>
-#endif
+#include <stdio.h>
+#include <thread>
+#include <unordered_set>
 
-std::ostream& out = std::cout;
+// how often the batch is polled, the transfers themselves run on the network thread
+#define SCRAPER_CMDLINE_POLL_MS 10
 
-void handle_interrupt_signal(int /*p*/)
-{
-	sleep(50);
-
-	LOG(LogInfo) << "Interrupt received during scrape...";
-
-	SystemData::deleteSystems();
+static std::atomic<bool> sInterrupted(false);
 
-	exit(1);
+static void handle_interrupt_signal(int /*p*/)
+{
+	// stopped from the main loop, which saves what was scraped
+	sInterrupted = true;
 }
 
-int run_scraper_cmdline()
+static std::string getCheckpointPath()
 {
-	out << "EmulationStation scraper\n";
-	out << "========================\n";
-	out << "\n";
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/scrape_checkpoint";
+}
 
-	signal(SIGINT, handle_interrupt_signal);
+static void writeJSONString(std::ostream& out, const std::string& str)
+{
+	out << '"';
 
-	//==================================================================================
-	//filter
-	//==================================================================================
-	enum FilterChoice
+	for(size_t i = 0; i < str.size(); i++)
 	{
-		FILTER_MISSING_IMAGES,
-		FILTER_ALL
-	};
-
-	int filter_choice;
-	do {
-		out << "Select filter for games to be scraped:\n";
-		out << FILTER_MISSING_IMAGES << " - games missing images\n";
-		out << FILTER_ALL << " - all games period, can overwrite existing metadata\n";
-
-		std::cin >> filter_choice;
-		std::cin.ignore(1, '\n'); //skip the unconsumed newline
-	} while(filter_choice < FILTER_MISSING_IMAGES || filter_choice > FILTER_ALL);
-
-	out << "\n";
+		const char c = str[i];
+		switch(c)
+		{
+			case '"':  out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n";  break;
+			case '\r': out << "\\r";  break;
+			case '\t': out << "\\t";  break;
+			default:
+			{
+				if((unsigned char)c < 0x20)
+				{
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					out << escaped;
+				}
+				else
+					out << c;
+			}
+			break;
+		}
+	}
 
-	//==================================================================================
-	//platforms
-	//==================================================================================
+	out << '"';
+}
 
+// the systems named on the command line, or those the scraper knows the platform of
+static std::vector<SystemData*> getSystems(const ScraperCmdLineOptions& options)
+{
 	std::vector<SystemData*> systems;
 
-	out << "You can scrape only specific platforms, or scrape all of them.\n";
-	out << "Would you like to scrape all platforms? (y/n)\n";
-
-	std::string system_choice;
-	std::getline(std::cin, system_choice);
-
-	if(system_choice == "y" || system_choice == "Y")
+	if(options.systems.empty())
 	{
-		out << "Will scrape all platforms.\n";
-		for(auto i = SystemData::sSystemVector.cbegin(); i != SystemData::sSystemVector.cend(); i++)
+		for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
 		{
-			out << "   " << (*i)->getName() << " (" << (*i)->getGameCount() << " games)\n";
-			systems.push_back(*i);
+			if(!(*it)->isCollection() && !(*it)->getPlatformIds().empty() && !(*it)->hasPlatformId(PlatformIds::PLATFORM_IGNORE))
+				systems.push_back(*it);
 		}
 
-	}else{
-		std::string sys_name;
-
-		out << "Enter the names of the platforms you would like to scrape, one at a time.\n";
-		out << "Type nothing and press enter when you are ready to continue.\n";
+		return systems;
+	}
 
-		do {
-			for(auto i = SystemData::sSystemVector.cbegin(); i != SystemData::sSystemVector.cend(); i++)
+	for(auto name = options.systems.cbegin(); name != options.systems.cend(); name++)
+	{
+		bool found = false;
+		for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
+		{
+			if(!(*it)->isCollection() && (*it)->getName() == *name)
 			{
-				if(std::find(systems.cbegin(), systems.cend(), (*i)) != systems.cend())
-					out << " C ";
-				else
-					out << "   ";
-
-				out << "\"" << (*i)->getName() << "\" (" << (*i)->getGameCount() << " games)\n";
-			}
-
-			std::getline(std::cin, sys_name);
-
-			if(sys_name.empty())
+				systems.push_back(*it);
+				found = true;
 				break;
-
-			bool found = false;
-			for(auto i = SystemData::sSystemVector.cbegin(); i != SystemData::sSystemVector.cend(); i++)
-			{
-				if((*i)->getName() == sys_name)
-				{
-					systems.push_back(*i);
-					found = true;
-					break;
-				}
 			}
+		}
 
-			if(!found)
-				out << "System not found.\n";
-
-		} while(true);
+		if(!found)
+			LOG(LogWarning) << "Scraper: system \"" << *name << "\" not found";
 	}
 
-	//==================================================================================
-	//manual mode
-	//==================================================================================
-
-	out << "\n";
-	out << "You can let the scraper try to automatically choose the best result, or\n";
-	out << "you can manually approve each result. This \"manual mode\" is much more accurate.\n";
-	out << "It is highly recommended you use manual mode unless you have a very large collection.\n";
-	out << "Scrape in manual mode? (y/n)\n";
+	return systems;
+}
 
-	std::string manual_mode_str;
-	std::getline(std::cin, manual_mode_str);
+// Scrapes without any interaction and reports progress on stdout as one JSON object per line.
+// Every game that is done is written to a checkpoint file once its gamelist is saved, a run
+// that was killed skips those games when started again. The file goes once a run completes.
+int run_scraper_cmdline(const ScraperCmdLineOptions& options)
+{
+	std::ostream& out = std::cout;
 
-	bool manual_mode = false;
+	signal(SIGINT, handle_interrupt_signal);
+	signal(SIGTERM, handle_interrupt_signal);
 
-	if(manual_mode_str == "y" || manual_mode_str == "Y")
+	// games done by a previous run that didn't complete
+	std::unordered_set<std::string> done;
 	{
-		manual_mode = true;
-		out << "Scraping in manual mode!\n";
-	}else{
-		out << "Scraping in automatic mode!\n";
+		std::ifstream checkpoint(getCheckpointPath());
+		std::string path;
+		while(std::getline(checkpoint, path))
+		{
+			if(!path.empty())
+				done.insert(path);
+		}
 	}
 
-	//==================================================================================
-	//scraping
-	//==================================================================================
-	out << "\n";
-	out << "Alright, let's do this thing!\n";
-	out << "=============================\n";
+	const std::vector<SystemData*> systems = getSystems(options);
 
-	/*
-	std::shared_ptr<Scraper> scraper = Settings::getInstance()->getScraper();
-	for(auto sysIt = systems.cbegin(); sysIt != systems.cend(); sysIt++)
+	std::queue<ScraperSearchParams> searches;
+	unsigned int resumed = 0;
+	for(auto sys = systems.cbegin(); sys != systems.cend(); sys++)
 	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
-
-		ScraperSearchParams params;
-		params.system = (*sysIt);
-
-		for(auto gameIt = files.cbegin(); gameIt != files.cend(); gameIt++)
+		std::vector<FileData*> games = (*sys)->getRootFolder()->getFilesRecursive(GAME);
+		for(auto game = games.cbegin(); game != games.cend(); game++)
 		{
-			params.nameOverride = "";
-			params.game = *gameIt;
-
-			//print original search term
-			out << getCleanFileName(params.game->getPath()) << "...\n";
-
-			//need to take into account filter_choice
-			if(filter_choice == FILTER_MISSING_IMAGES)
+			if(done.find((*game)->getPath()) != done.cend())
 			{
-				if(!params.game->metadata.get("image").empty()) //maybe should also check if the image file exists/is a URL
-				{
-					out << "   Skipping, metadata \"image\" entry is not empty.\n";
-					continue;
-				}
+				resumed++;
+				continue;
 			}
 
-			//actually get some results
-			do {
-				std::vector<MetaDataList> mdls = scraper->getResults(params);
+			if(!options.all && !(*game)->metadata.get("image").empty())
+				continue;
 
-				//no results
-				if(mdls.size() == 0)
-				{
-					if(manual_mode)
-					{
-						//in manual mode let the user enter a custom search
-						out << "   NO RESULTS FOUND! Enter a new name to search for, or nothing to skip.\n";
+			ScraperSearchParams search;
+			search.game = *game;
+			search.system = *sys;
+			searches.push(search);
+		}
+	}
 
-						std::getline(std::cin, params.nameOverride);
+	out << "{\"event\":\"start\",\"games\":" << searches.size() << ",\"resumed\":" << resumed << ",\"systems\":[";
+	for(size_t i = 0; i < systems.size(); i++)
+	{
+		if(i > 0)
+			out << ',';
+		writeJSONString(out, systems[i]->getName());
+	}
+	out << "]}" << std::endl;
 
-						if(params.nameOverride.empty())
-						{
-							out << "   Skipping...\n";
-							break;
-						}
+	const HttpCache::Stats cacheStats = HttpCache::getInstance().getStats();
 
-						continue;
+	// games done since the last save, they go to the checkpoint once their gamelist is written
+	std::vector<std::string> pending;
+	std::ofstream checkpoint(getCheckpointPath(), std::ios_base::out | std::ios_base::app);
 
-					}else{
-						out << "   NO RESULTS FOUND! Skipping...\n";
-						break;
-					}
-				}
+	ScraperBatch batch(searches);
 
-				//some results
-				if(manual_mode)
-				{
-					//print list of choices
-					for(unsigned int i = 0; i < mdls.size(); i++)
-					{
-						out << "   " << i << " - " << mdls.at(i).get("name") << "\n";
-					}
-
-					int choice = -1;
-					std::string choice_str;
-
-					out << "Your choice: ";
-
-					std::getline(std::cin, choice_str);
-					std::stringstream choice_buff(choice_str); //convert to int
-					choice_buff >> choice;
-
-					if(choice >= 0 && choice < (int)mdls.size())
-					{
-						params.game->metadata = mdls.at(choice);
-						break;
-					}else{
-						out << "Invalid choice.\n";
-						continue;
-					}
-
-				}else{
-					//automatic mode
-					//always choose the first choice
-					out << "   name -> " << mdls.at(0).get("name") << "\n";
-					params.game->metadata = mdls.at(0);
-					break;
-				}
+	if(options.maxSearches > 0)
+		batch.setMaxSearches(options.maxSearches);
 
-			} while(true);
+	batch.setGameDoneCallback([&](const ScraperSearchParams& params, const ScraperSearchResult* result, const std::string& error)
+	{
+		out << "{\"event\":\"game\",\"system\":";
+		writeJSONString(out, params.system->getName());
+		out << ",\"path\":";
+		writeJSONString(out, params.game->getPath());
+		out << ",\"status\":" << (result ? "\"scraped\"" : (error.empty() ? "\"skipped\"" : "\"failed\""));
 
-			out << "===================\n";
+		if(result)
+		{
+			out << ",\"name\":";
+			writeJSONString(out, result->mdl.get("name"));
 		}
-	}
+		else if(!error.empty())
+		{
+			out << ",\"error\":";
+			writeJSONString(out, error);
+		}
+
+		out << ",\"completed\":" << batch.getCompletedGames() << ",\"total\":" << batch.getTotalGames() << "}" << std::endl;
 
-	out << "\n\n";
-	out << "Downloading boxart...\n";
+		// failed games are not checkpointed so resuming the run tries them again
+		if(result || error.empty())
+			pending.push_back(params.game->getPath());
+	});
 
-	for(auto sysIt = systems.cbegin(); sysIt != systems.cend(); sysIt++)
+	batch.setSavedCallback([&]
 	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
+		for(auto it = pending.cbegin(); it != pending.cend(); it++)
+			checkpoint << *it << '\n';
+		checkpoint.flush();
+		pending.clear();
 
-		for(auto gameIt = files.cbegin(); gameIt != files.cend(); gameIt++)
-		{
-			FileData* game = *gameIt;
-			const std::vector<MetaDataDecl>& mdd = game->metadata.getMDD();
-			for(auto i = mdd.cbegin(); i != mdd.cend(); i++)
-			{
-				std::string key = i->key;
-				std::string url = game->metadata.get(key);
+		out << "{\"event\":\"checkpoint\",\"completed\":" << batch.getCompletedGames() << "}" << std::endl;
+	});
 
-				if(i->type == MD_IMAGE_PATH && HttpReq::isUrl(url))
-				{
-					std::string urlShort = url.substr(0, url.length() > 35 ? 35 : url.length());
-					if(url.length() != urlShort.length()) urlShort += "...";
-
-					out << "   " << game->metadata.get("name") << " [from: " << urlShort << "]...\n";
-
-					ScraperSearchParams p;
-					p.game = game;
-					p.system = *sysIt;
-					game->metadata.set(key, downloadImage(url, getSaveAsPath(p, key, url)));
-					if(game->metadata.get(key).empty())
-					{
-						out << "     FAILED! Skipping.\n";
-						game->metadata.set(key, url); //result URL to what it was if download failed, retry some other time
-					}
-				}
-			}
-		}
+	while(!batch.isDone() && !sInterrupted)
+	{
+		batch.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(SCRAPER_CMDLINE_POLL_MS));
 	}
 
+	// a batch that is done saved itself in its last update
+	const bool interrupted = !batch.isDone();
+	if(interrupted)
+		batch.stop();
+
+	checkpoint.close();
+	if(!interrupted)
+		Utils::FileSystem::removeFile(getCheckpointPath());
 
-	out << "\n\n";
-	out << "==============================\n";
-	out << "SCRAPE COMPLETE!\n";
-	out << "==============================\n";
-	*/
+	const HttpCache::Stats cacheStatsEnd = HttpCache::getInstance().getStats();
+	out << "{\"event\":\"" << (interrupted ? "interrupted" : "done") << "\""
+		<< ",\"scraped\":" << batch.getTotalSuccessful()
+		<< ",\"skipped\":" << batch.getTotalSkipped()
+		<< ",\"failed\":" << batch.getTotalFailed()
+		<< ",\"cache_hits\":" << (cacheStatsEnd.hits - cacheStats.hits)
+		<< ",\"cache_misses\":" << (cacheStatsEnd.misses - cacheStats.misses) << "}" << std::endl;
 
-	out << "\n\n";
-	out << "ACTUALLY THIS IS STILL TODO\n";
+	batch.setSavedCallback(nullptr);
+	batch.setGameDoneCallback(nullptr);
 
-	return 0;
+	return interrupted ? 1 : 0;
 }
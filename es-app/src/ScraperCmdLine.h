@@ -2,6 +2,18 @@
 #ifndef ES_APP_SCRAPER_CMD_LINE_H
 #define ES_APP_SCRAPER_CMD_LINE_H
 
-int run_scraper_cmdline();
+#include <string>
+#include <vector>
+
+struct ScraperCmdLineOptions
+{
+	ScraperCmdLineOptions() : all(false), maxSearches(0) {}
+
+	std::vector<std::string> systems; // empty for every system with a platform set
+	bool all;                         // also games that have an image already
+	unsigned int maxSearches;         // 0 for the limit of the scraper
+};
+
+int run_scraper_cmdline(const ScraperCmdLineOptions& options);
 
 #endif // ES_APP_SCRAPER_CMD_LINE_H
@@ -5,6 +5,7 @@
 #include "FileFilterIndex.h"
 #include "FileSorts.h"
 #include "Gamelist.h"
+#include "LocalArtIndex.h"
 #include "Log.h"
 #include "platform.h"
 #include "Settings.h"
@@ -12,8 +13,10 @@
 #include "views/UIModeController.h"
 #include <fstream>
 #include <random>
+#include <SDL_timer.h>
 #include "utils/StringUtil.h"
 #include "utils/ThreadPool.h"
+#include "utils/TracingUtil.h"
 #include "Window.h"
 
 using namespace Utils;
@@ -24,25 +27,38 @@ std::ranlux48 SystemData::sURNG = std::ranlux48(std::random_device()());
 
 
 SystemData::SystemData(const std::string& name, const std::string& fullName, SystemEnvironmentData* envData, const std::string& themeFolder, bool CollectionSystem) :
-	mName(name), mFullName(fullName), mEnvData(envData), mThemeFolder(themeFolder), mIsCollectionSystem(CollectionSystem), mIsGameSystem(true)
+	mName(name), mFullName(fullName), mEnvData(envData), mThemeFolder(themeFolder), mIsCollectionSystem(CollectionSystem), mIsGameSystem(true),
+	mMediaFlags(0), mMediaFlagsValid(false), mMediaFlagsLocalArt(false), mMediaFlagsGeneration(0), mLocalArt(nullptr)
 {
 	mFilterIndex = new FileFilterIndex();
+	mExtensions.insert(mEnvData->mSearchExtensions.cbegin(), mEnvData->mSearchExtensions.cend());
 
 	// if it's an actual system, initialize it, if not, just create the data structure
 	if(!CollectionSystem)
 	{
 		mRootFolder = new FileData(FOLDER, mEnvData->mStartPath, mEnvData, this);
 		mRootFolder->metadata.set("name", mFullName);
+		mLocalArt = new LocalArtIndex(mEnvData->mStartPath + "/images");
 
 		if(!Settings::getInstance()->getBool("ParseGamelistOnly"))
+		{
+			TraceScopeArg("SystemData::populateFolder", mName);
 			populateFolder(mRootFolder);
+		}
 
 		if(!Settings::getInstance()->getBool("IgnoreGamelist"))
 			parseGamelist(this);
 
 		mRootFolder->sort(FileSorts::SortTypes.at(0));
 
+		const unsigned int indexStart = SDL_GetTicks();
 		indexAllGameFilters(mRootFolder);
+		const GameSearchIndex& searchIndex = mFilterIndex->getSearchIndex();
+		LOG(LogDebug) << "Indexed " << searchIndex.size() << " games of " << mName << " in " << (SDL_GetTicks() - indexStart) << "ms, "
+			<< searchIndex.getTrigramCount() << " trigrams, " << (searchIndex.getMemoryUsage() / 1024) << "KB";
+
+		// systems load in parallel, get the media scan out of the way while we're at it
+		getMediaFlags();
 	}
 	else
 	{
@@ -60,6 +76,7 @@ SystemData::~SystemData()
 
 	delete mRootFolder;
 	delete mFilterIndex;
+	delete mLocalArt;
 }
 
 void SystemData::setIsGameSystemStatus()
@@ -70,6 +87,88 @@ void SystemData::setIsGameSystemStatus()
 	mIsGameSystem = (mName != "retropie");
 }
 
+unsigned int SystemData::getMediaFlags()
+{
+	const bool localArt = Settings::getInstance()->getBool("LocalArt");
+	const unsigned int generation = mLocalArt ? mLocalArt->getGeneration() : 0;
+	if(mMediaFlagsValid && mMediaFlagsLocalArt == localArt && mMediaFlagsGeneration == generation)
+		return mMediaFlags;
+
+	unsigned int flags = 0;
+	std::vector<FileData*> files = mRootFolder->getFilesRecursive(GAME | FOLDER);
+	for(auto it = files.cbegin(); it != files.cend() && flags != MEDIA_ALL; it++)
+	{
+		const MetaDataList& md = (*it)->metadata;
+		if(!md.get("image").empty())
+			flags |= MEDIA_IMAGE | MEDIA_THUMBNAIL;
+		if(!md.get("thumbnail").empty())
+			flags |= MEDIA_THUMBNAIL;
+		if(!md.get("video").empty())
+			flags |= MEDIA_VIDEO;
+		if(!md.get("marquee").empty())
+			flags |= MEDIA_MARQUEE;
+
+		// same fallbacks as the FileData getters, local images are used for the image even without LocalArt
+		const bool needImage = !(flags & MEDIA_IMAGE) || (localArt && !(flags & MEDIA_THUMBNAIL));
+		const bool needVideo = localArt && !(flags & MEDIA_VIDEO);
+		const bool needMarquee = localArt && !(flags & MEDIA_MARQUEE);
+		if(!needImage && !needVideo && !needMarquee)
+			continue;
+
+		// collection games keep their art next to the roms of the system they come from
+		const unsigned int files = (*it)->getSourceFileData()->getSystem()->getLocalArt((*it)->getDisplayName());
+
+		if(needImage && (files & (LOCAL_ART_IMAGE_PNG | LOCAL_ART_IMAGE_JPG)))
+			flags |= MEDIA_IMAGE | (localArt ? MEDIA_THUMBNAIL : 0);
+		if(needVideo && (files & LOCAL_ART_VIDEO_MP4))
+			flags |= MEDIA_VIDEO;
+		if(needMarquee && (files & (LOCAL_ART_MARQUEE_PNG | LOCAL_ART_MARQUEE_JPG)))
+			flags |= MEDIA_MARQUEE;
+	}
+
+	mMediaFlags = flags;
+	mMediaFlagsValid = true;
+	mMediaFlagsLocalArt = localArt;
+	mMediaFlagsGeneration = generation;
+	return mMediaFlags;
+}
+
+unsigned int SystemData::getLocalArt(const std::string& name)
+{
+	// collections have no images folder, their games are looked up in the system they come from
+	if(mLocalArt == nullptr)
+		return 0;
+
+	return mLocalArt->get(name);
+}
+
+std::string SystemData::getLocalArtPath(const std::string& name, unsigned int files) const
+{
+	if(mLocalArt == nullptr || files == 0)
+		return "";
+
+	return mLocalArt->getPath(name, files);
+}
+
+FileData* SystemData::getFileByPath(const std::string& path) const
+{
+	auto it = mFilesByPath.find(path);
+	return it != mFilesByPath.cend() ? it->second : nullptr;
+}
+
+void SystemData::addToPathIndex(FileData* file)
+{
+	mFilesByPath[file->getPath()] = file;
+}
+
+void SystemData::removeFromPathIndex(FileData* file)
+{
+	// an other file with the same path may have replaced it
+	auto it = mFilesByPath.find(file->getPath());
+	if(it != mFilesByPath.cend() && it->second == file)
+		mFilesByPath.erase(it);
+}
+
 void SystemData::populateFolder(FileData* folder)
 {
 	const std::string& folderPath = folder->getPath();
@@ -111,7 +210,7 @@ void SystemData::populateFolder(FileData* folder)
 		//see issue #75: https://github.com/Aloshi/EmulationStation/issues/75
 
 		isGame = false;
-		if(std::find(mEnvData->mSearchExtensions.cbegin(), mEnvData->mSearchExtensions.cend(), extension) != mEnvData->mSearchExtensions.cend())
+		if(hasExtension(extension))
 		{
 			FileData* newGame = new FileData(GAME, filePath, mEnvData, this);
 
@@ -178,6 +277,7 @@ SystemData* SystemData::loadSystem(pugi::xml_node system)
 	std::string name, fullname, path, cmd, themeFolder, defaultCore;
 
 	name = system.child("name").text().get();
+	TraceScopeArg("SystemData::loadSystem", name);
 	fullname = system.child("fullname").text().get();
 	path = system.child("path").text().get();
 	defaultCore = system.child("defaultCore").text().get();
@@ -262,6 +362,7 @@ SystemData* SystemData::loadSystem(pugi::xml_node system)
 //creates systems from information located in a config file
 bool SystemData::loadConfig(Window* window)
 {
+	TraceScope("SystemData::loadConfig");
 	deleteSystems();
 
 	std::string path = getConfigPath(false);
@@ -387,6 +488,9 @@ bool SystemData::loadConfig(Window* window)
 		CollectionSystemManager::get()->loadCollectionSystems();
 	}
 
+	// every system and collection has loaded its theme by now
+	ThemeData::pruneCache();
+
 	return true;
 }
 
@@ -582,6 +686,7 @@ unsigned int SystemData::getDisplayedGameCount() const
 
 void SystemData::loadTheme()
 {
+	TraceScopeArg("SystemData::loadTheme", mName);
 	mTheme = std::make_shared<ThemeData>();
 
 	std::string path = getThemePath();
@@ -597,7 +702,9 @@ void SystemData::loadTheme()
 		sysData.insert(std::pair<std::string, std::string>("system.theme", getThemeFolder()));
 		sysData.insert(std::pair<std::string, std::string>("system.fullName", getFullName()));
 
+		const Uint32 startTime = SDL_GetTicks();
 		mTheme->loadFile(sysData, path);
+		LOG(LogInfo) << "Loaded theme for system \"" << getName() << "\" in " << (SDL_GetTicks() - startTime) << "ms";
 	} catch(ThemeException& e)
 	{
 		LOG(LogError) << e.what();
@@ -7,12 +7,15 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <pugixml.hpp>
 
 class FileData;
 class FileFilterIndex;
+class LocalArtIndex;
 class ThemeData;
 class Window;
 
@@ -24,6 +27,16 @@ struct SystemEnvironmentData
 	std::vector<PlatformIds::PlatformId> mPlatformIds;
 };
 
+// Kinds of media at least one game of a system has, each matches a FileData getter returning a path
+enum MediaFlags : unsigned int
+{
+	MEDIA_IMAGE     = 1, // getImagePath()
+	MEDIA_THUMBNAIL = 2, // getThumbnailPath()
+	MEDIA_VIDEO     = 4, // getVideoPath()
+	MEDIA_MARQUEE   = 8, // getMarqueePath()
+	MEDIA_ALL       = 15
+};
+
 class SystemData
 {
 public:
@@ -35,6 +48,7 @@ public:
 	inline const std::string& getFullName() const { return mFullName; }
 	inline const std::string& getStartPath() const { return mEnvData->mStartPath; }
 	inline const std::vector<std::string>& getExtensions() const { return mEnvData->mSearchExtensions; }
+	inline bool hasExtension(const std::string& extension) const { return mExtensions.find(extension) != mExtensions.cend(); }
 	inline const std::string& getThemeFolder() const { return mThemeFolder; }
 	inline SystemEnvironmentData* getSystemEnvData() const { return mEnvData; }
 	inline const std::vector<PlatformIds::PlatformId>& getPlatformIds() const { return mEnvData->mPlatformIds; }
@@ -78,6 +92,20 @@ public:
 	void onMetaDataSavePoint();
 	void setShuffledCacheDirty();
 
+	// MediaFlags of the games, computed from the gamelist and a single listing of the images folder
+	// and kept until a game changes. Lets callers skip the path getters for media nobody has.
+	unsigned int getMediaFlags();
+	inline void invalidateMediaFlags() { mMediaFlagsValid = false; }
+
+	// Returns the LocalArtFile flags of the art in the images folder next to the roms for a game's display name.
+	unsigned int getLocalArt(const std::string& name);
+	std::string getLocalArtPath(const std::string& name, unsigned int files) const;
+
+	// Every file and folder below the root folder by path, kept up to date by FileData::addChild and removeChild.
+	FileData* getFileByPath(const std::string& path) const;
+	void addToPathIndex(FileData* file);
+	void removeFromPathIndex(FileData* file);
+
 private:
 	static SystemData* loadSystem(pugi::xml_node system);
 
@@ -99,6 +127,15 @@ private:
 	FileData* mRootFolder;
 	// for getRandomGame()
 	std::vector<FileData*> mGamesShuffled;
+
+	unsigned int mMediaFlags;
+	bool mMediaFlagsValid;
+	bool mMediaFlagsLocalArt; // LocalArt setting the flags were computed with
+	unsigned int mMediaFlagsGeneration; // generation of mLocalArt the flags were computed with
+	LocalArtIndex* mLocalArt;
+
+	std::unordered_set<std::string> mExtensions;
+	std::unordered_map<std::string, FileData*> mFilesByPath;
 };
 
 #endif // ES_APP_SYSTEM_DATA_H
@@ -35,6 +35,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() const override { return true; } // spinner runs until the request completes and we delete ourselves
 
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
 private:
@@ -144,20 +144,20 @@ void RatingComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const
 		return;
 
 	bool imgChanged = false;
-	if(properties & PATH && elem->has("filledPath"))
+	if(properties & PATH && elem->has(ThemeProperty::FILLED_PATH))
 	{
-		mFilledTexture = TextureResource::get(elem->get<std::string>("filledPath"), true);
+		mFilledTexture = TextureResource::get(elem->get<std::string>(ThemeProperty::FILLED_PATH), true);
 		imgChanged = true;
 	}
-	if(properties & PATH && elem->has("unfilledPath"))
+	if(properties & PATH && elem->has(ThemeProperty::UNFILLED_PATH))
 	{
-		mUnfilledTexture = TextureResource::get(elem->get<std::string>("unfilledPath"), true);
+		mUnfilledTexture = TextureResource::get(elem->get<std::string>(ThemeProperty::UNFILLED_PATH), true);
 		imgChanged = true;
 	}
 
 
-	if(properties & COLOR && elem->has("color"))
-		setColorShift(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColorShift(elem->get<unsigned int>(ThemeProperty::COLOR));
 
 	if(imgChanged)
 		onSizeChanged();
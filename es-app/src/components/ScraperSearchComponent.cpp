@@ -221,6 +221,27 @@ void ScraperSearchComponent::stop()
 	mBlockAccept = false;
 }
 
+void ScraperSearchComponent::showResult(const ScraperSearchResult& result)
+{
+	stop();
+
+	mResultList->clear();
+	mScraperResults.clear();
+	mScraperResults.push_back(result);
+
+	// the image is on disk already, don't download the thumbnail again
+	mScraperResults.back().thumbnailUrl = "";
+	mScraperResults.back().imageUrl = "";
+	updateInfoPane();
+
+	const std::string image = result.mdl.get("image");
+	if(!image.empty())
+	{
+		mResultThumbnail->setImage(image);
+		mGrid.onSizeChanged();
+	}
+}
+
 void ScraperSearchComponent::onSearchDone(const std::vector<ScraperSearchResult>& results)
 {
 	mResultList->clear();
@@ -429,11 +450,20 @@ void ScraperSearchComponent::update(int deltaTime)
 	}
 }
 
+bool ScraperSearchComponent::isAnimating() const
+{
+	// results arrive from pending requests polled in update(), keep drawing until they are done
+	if(mBlockAccept || mSearchHandle || mMDResolveHandle || mThumbnailReq)
+		return true;
+
+	return GuiComponent::isAnimating();
+}
+
 void ScraperSearchComponent::updateThumbnail()
 {
 	if(mThumbnailReq && mThumbnailReq->status() == HttpReq::REQ_SUCCESS)
 	{
-		std::string content = mThumbnailReq->getContent();
+		const std::string& content = mThumbnailReq->getContent();
 		mResultThumbnail->setImage(content.data(), content.length());
 		mGrid.onSizeChanged(); // a hack to fix the thumbnail position since its size changed
 	}else{
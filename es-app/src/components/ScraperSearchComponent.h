@@ -29,6 +29,8 @@ public:
 	void search(const ScraperSearchParams& params);
 	void openInputScreen(ScraperSearchParams& from);
 	void stop();
+	// shows a result scraped elsewhere, its media already downloaded
+	void showResult(const ScraperSearchResult& result);
 	inline SearchType getSearchType() const { return mSearchType; }
 
 	// Metadata assets will be resolved before calling the accept callback (e.g. result.mdl's "image" is automatically downloaded and properly set).
@@ -39,6 +41,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() const override;
 	std::vector<HelpPrompt> getHelpPrompts() override;
 	void onSizeChanged() override;
 	void onFocusGained() override;
@@ -46,6 +46,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() const override;
 	void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	void add(const std::string& name, const T& obj, unsigned int colorId);
@@ -92,6 +93,7 @@ private:
 	int mMarqueeOffset;
 	int mMarqueeOffset2;
 	int mMarqueeTime;
+	bool mMarqueeMoved;
 
 	Alignment mAlignment;
 	float mHorizontalMargin;
@@ -124,6 +126,7 @@ TextListComponent<T>::TextListComponent(Window* window) :
 	mMarqueeOffset = 0;
 	mMarqueeOffset2 = 0;
 	mMarqueeTime = 0;
+	mMarqueeMoved = false;
 
 	mHorizontalMargin = 0;
 	mAlignment = ALIGN_CENTER;
@@ -328,6 +331,9 @@ void TextListComponent<T>::update(int deltaTime)
 {
 	listUpdate(deltaTime);
 
+	const int prevMarqueeOffset = mMarqueeOffset;
+	const int prevMarqueeOffset2 = mMarqueeOffset2;
+
 	if(!isScrolling() && size() > 0)
 	{
 		// always reset the marquee offsets
@@ -362,9 +368,18 @@ void TextListComponent<T>::update(int deltaTime)
 		}
 	}
 
+	// the marquee sits still during its start delay, only redraw when it actually moved
+	mMarqueeMoved = (mMarqueeOffset != prevMarqueeOffset) || (mMarqueeOffset2 != prevMarqueeOffset2);
+
 	GuiComponent::update(deltaTime);
 }
 
+template <typename T>
+bool TextListComponent<T>::isAnimating() const
+{
+	return mMarqueeMoved || IList<TextListData, T>::isAnimating();
+}
+
 //list management stuff
 template <typename T>
 void TextListComponent<T>::add(const std::string& name, const T& obj, unsigned int color)
@@ -406,21 +421,21 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 	using namespace ThemeFlags;
 	if(properties & COLOR)
 	{
-		if(elem->has("selectorColor"))
+		if(elem->has(ThemeProperty::SELECTOR_COLOR))
 		{
-			setSelectorColor(elem->get<unsigned int>("selectorColor"));
-			setSelectorColorEnd(elem->get<unsigned int>("selectorColor"));
+			setSelectorColor(elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR));
+			setSelectorColorEnd(elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR));
 		}
-		if (elem->has("selectorColorEnd"))
-			setSelectorColorEnd(elem->get<unsigned int>("selectorColorEnd"));
-		if (elem->has("selectorGradientType"))
-			setSelectorColorGradientHorizontal(!(elem->get<std::string>("selectorGradientType").compare("horizontal")));
-		if(elem->has("selectedColor"))
-			setSelectedColor(elem->get<unsigned int>("selectedColor"));
-		if(elem->has("primaryColor"))
-			setColor(0, elem->get<unsigned int>("primaryColor"));
-		if(elem->has("secondaryColor"))
-			setColor(1, elem->get<unsigned int>("secondaryColor"));
+		if (elem->has(ThemeProperty::SELECTOR_COLOR_END))
+			setSelectorColorEnd(elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR_END));
+		if (elem->has(ThemeProperty::SELECTOR_GRADIENT_TYPE))
+			setSelectorColorGradientHorizontal(!(elem->get<std::string>(ThemeProperty::SELECTOR_GRADIENT_TYPE).compare("horizontal")));
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			setSelectedColor(elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR));
+		if(elem->has(ThemeProperty::PRIMARY_COLOR))
+			setColor(0, elem->get<unsigned int>(ThemeProperty::PRIMARY_COLOR));
+		if(elem->has(ThemeProperty::SECONDARY_COLOR))
+			setColor(1, elem->get<unsigned int>(ThemeProperty::SECONDARY_COLOR));
 	}
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
@@ -432,15 +447,15 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
                 // Clear any previous theme scroll sound so themes can remove the override.
                 mScrollSound.clear();
 
-                if(elem->has("scrollSound"))
-                        mScrollSound = elem->get<std::string>("scrollSound");
+                if(elem->has(ThemeProperty::SCROLL_SOUND))
+                        mScrollSound = elem->get<std::string>(ThemeProperty::SCROLL_SOUND);
         }
 
 	if(properties & ALIGNMENT)
 	{
-		if(elem->has("alignment"))
+		if(elem->has(ThemeProperty::ALIGNMENT))
 		{
-			const std::string& str = elem->get<std::string>("alignment");
+			const std::string& str = elem->get<std::string>(ThemeProperty::ALIGNMENT);
 			if(str == "left")
 				setAlignment(ALIGN_LEFT);
 			else if(str == "center")
@@ -450,36 +465,36 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 			else
 				LOG(LogError) << "Unknown TextListComponent alignment \"" << str << "\"!";
 		}
-		if(elem->has("horizontalMargin"))
+		if(elem->has(ThemeProperty::HORIZONTAL_MARGIN))
 		{
-			mHorizontalMargin = elem->get<float>("horizontalMargin") * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
+			mHorizontalMargin = elem->get<float>(ThemeProperty::HORIZONTAL_MARGIN) * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
 		}
 	}
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
 	if(properties & LINE_SPACING)
 	{
-		if(elem->has("lineSpacing"))
-			setLineSpacing(elem->get<float>("lineSpacing"));
-		if(elem->has("selectorHeight"))
+		if(elem->has(ThemeProperty::LINE_SPACING))
+			setLineSpacing(elem->get<float>(ThemeProperty::LINE_SPACING));
+		if(elem->has(ThemeProperty::SELECTOR_HEIGHT))
 		{
-			setSelectorHeight(elem->get<float>("selectorHeight") * Renderer::getScreenHeight());
+			setSelectorHeight(elem->get<float>(ThemeProperty::SELECTOR_HEIGHT) * Renderer::getScreenHeight());
 		}
-		if(elem->has("selectorOffsetY"))
+		if(elem->has(ThemeProperty::SELECTOR_OFFSET_Y))
 		{
 			float scale = this->mParent ? this->mParent->getSize().y() : (float)Renderer::getScreenHeight();
-			setSelectorOffsetY(elem->get<float>("selectorOffsetY") * scale);
+			setSelectorOffsetY(elem->get<float>(ThemeProperty::SELECTOR_OFFSET_Y) * scale);
 		} else {
 			setSelectorOffsetY(0.0);
 		}
 	}
 
-	if (elem->has("selectorImagePath"))
+	if (elem->has(ThemeProperty::SELECTOR_IMAGE_PATH))
 	{
-		std::string path = elem->get<std::string>("selectorImagePath");
-		bool tile = elem->has("selectorImageTile") && elem->get<bool>("selectorImageTile");
+		std::string path = elem->get<std::string>(ThemeProperty::SELECTOR_IMAGE_PATH);
+		bool tile = elem->has(ThemeProperty::SELECTOR_IMAGE_TILE) && elem->get<bool>(ThemeProperty::SELECTOR_IMAGE_TILE);
 		mSelectorImage.setImage(path, tile);
 		mSelectorImage.setSize(mSize.x(), mSelectorHeight);
 		mSelectorImage.setColorShift(mSelectorColor);
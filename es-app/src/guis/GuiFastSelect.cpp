@@ -142,23 +142,26 @@ void GuiFastSelect::updateGameListSort()
 
 void GuiFastSelect::updateGameListCursor()
 {
-	const std::vector<FileData*>& list = mGameList->getCursor()->getParent()->getChildrenListToDisplay();
-
 	// only skip by letter when the sort mode is alphabetical
 	const FileData::SortType& sort = FileSorts::SortTypes.at(mSortId);
 	if(sort.comparisonFunction != &FileSorts::compareName)
 		return;
 
-	// find the first entry in the list that either exactly matches our target letter or is beyond our target letter
-	for(auto it = list.cbegin(); it != list.cend(); it++)
-	{
-		char check = (*it)->getName().empty() ? 'A' : (*it)->getName()[0];
+	FileData* folder = mGameList->getCursor()->getParent();
 
-		// if there's an exact match or we've passed it, set the cursor to this one
-		if(check == LETTERS[mLetterId] || (sort.ascending && check > LETTERS[mLetterId]) || (!sort.ascending && check < LETTERS[mLetterId]))
-		{
-			mGameList->setCursor(*it);
-			break;
-		}
+	// the first entry that either exactly matches our target letter or is beyond our target letter
+	int position = -1;
+	if(sort.ascending)
+	{
+		for(int letter = (unsigned char)LETTERS[mLetterId]; letter < 256 && position == -1; letter++)
+			position = folder->getFirstLetterPosition((unsigned char)letter);
+	}
+	else
+	{
+		for(int letter = (unsigned char)LETTERS[mLetterId]; letter >= 0 && position == -1; letter--)
+			position = folder->getFirstLetterPosition((unsigned char)letter);
 	}
+
+	if(position != -1)
+		mGameList->setCursor(folder->getChildrenListToDisplay().at(position));
 }
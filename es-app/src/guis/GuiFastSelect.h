@@ -15,6 +15,7 @@ public:
 
 	bool input(InputConfig* config, Input input);
 	void update(int deltaTime);
+	bool isAnimating() const override { return mScrollDir != 0 || GuiComponent::isAnimating(); }
 
 private:
 	void setScrollDir(int dir);
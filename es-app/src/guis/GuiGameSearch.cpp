@@ -0,0 +1,116 @@
+#include "guis/GuiGameSearch.h"
+
+#include "components/ComponentList.h"
+#include "components/TextComponent.h"
+#include "components/TextEditComponent.h"
+#include "utils/StringUtil.h"
+#include "views/gamelist/IGameListView.h"
+#include "views/ViewController.h"
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "Log.h"
+#include "SystemData.h"
+#include <chrono>
+
+#define SEARCH_MAX_RESULTS 50
+
+GuiGameSearch::GuiGameSearch(Window* window, SystemData* system) : GuiComponent(window),
+	mBackground(window, ":/frame.png"), mGrid(window, Vector2i(1, 3)), mSystem(system)
+{
+	addChild(&mBackground);
+	addChild(&mGrid);
+
+	mTitle = std::make_shared<TextComponent>(mWindow, "SEARCH " + Utils::String::toUpper(mSystem->getFullName()), Font::get(FONT_SIZE_LARGE), 0x555555FF, ALIGN_CENTER);
+	mGrid.setEntry(mTitle, Vector2i(0, 0), false, true);
+
+	mText = std::make_shared<TextEditComponent>(mWindow);
+	mText->setSize(0, mText->getFont()->getHeight());
+	mGrid.setEntry(mText, Vector2i(0, 1), true, false, Vector2i(1, 1), GridFlags::BORDER_TOP | GridFlags::BORDER_BOTTOM);
+
+	mList = std::make_shared<ComponentList>(mWindow);
+	mGrid.setEntry(mList, Vector2i(0, 2), true, true);
+
+	setSize(Renderer::getScreenWidth() * 0.6f, Renderer::getScreenHeight() * 0.8f);
+	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
+}
+
+void GuiGameSearch::onSizeChanged()
+{
+	mBackground.fitTo(mSize, Vector3f::Zero(), Vector2f(-32, -32));
+
+	mText->setSize(mSize.x() - 40, mText->getSize().y());
+
+	mGrid.setRowHeightPerc(0, mTitle->getFont()->getHeight() / mSize.y(), false);
+	mGrid.setRowHeightPerc(1, (mText->getSize().y() + 8) / mSize.y(), false);
+	mGrid.setSize(mSize);
+}
+
+void GuiGameSearch::update(int deltaTime)
+{
+	GuiComponent::update(deltaTime);
+
+	// the results follow what is typed
+	const std::string query = mText->getValue();
+	if(query != mQuery)
+	{
+		mQuery = query;
+		updateResults();
+	}
+}
+
+void GuiGameSearch::updateResults()
+{
+	mList->clear();
+
+	const auto start = std::chrono::steady_clock::now();
+	FileFilterIndex* index = mSystem->getIndex();
+	// games the active filters hide are left out before the results are cut, not after
+	std::function<bool(FileData*)> filter;
+	if(index->isFiltered())
+		filter = [index](FileData* game) { return index->showFile(game); };
+
+	const std::vector<GameSearchIndex::Result> results = index->getSearchIndex().search(mQuery, SEARCH_MAX_RESULTS, filter);
+	LOG(LogDebug) << "Searched " << index->getSearchIndex().size() << " games for \"" << mQuery << "\" in "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() << "us";
+
+	auto font = Font::get(FONT_SIZE_MEDIUM);
+	ComponentListRow row;
+	for(auto it = results.cbegin(); it != results.cend(); it++)
+	{
+		FileData* game = it->game;
+		std::string name = Utils::String::toUpper(game->getName());
+		if(mSystem->isCollection())
+			name += " [" + Utils::String::toUpper(game->getSourceFileData()->getSystem()->getName()) + "]";
+
+		row.elements.clear();
+		row.addElement(std::make_shared<TextComponent>(mWindow, name, font, 0x777777FF), true);
+		row.makeAcceptInputHandler([this, game]
+		{
+			ViewController::get()->getGameListView(mSystem)->setCursor(game);
+			delete this;
+		});
+		mList->addRow(row);
+	}
+}
+
+bool GuiGameSearch::input(InputConfig* config, Input input)
+{
+	if(GuiComponent::input(config, input))
+		return true;
+
+	// pressing back when not text editing closes us
+	if(config->isMappedTo("b", input) && input.value)
+	{
+		delete this;
+		return true;
+	}
+
+	return false;
+}
+
+std::vector<HelpPrompt> GuiGameSearch::getHelpPrompts()
+{
+	std::vector<HelpPrompt> prompts = mGrid.getHelpPrompts();
+	prompts.push_back(HelpPrompt("b", "back"));
+	return prompts;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#ifndef ES_APP_GUIS_GUI_GAME_SEARCH_H
+#define ES_APP_GUIS_GUI_GAME_SEARCH_H
+
+#include "components/ComponentGrid.h"
+#include "components/NinePatchComponent.h"
+#include "GuiComponent.h"
+
+class ComponentList;
+class SystemData;
+class TextComponent;
+class TextEditComponent;
+
+// Searches the games of a system by name as the user types, selecting one moves the gamelist cursor to it.
+class GuiGameSearch : public GuiComponent
+{
+public:
+	GuiGameSearch(Window* window, SystemData* system);
+
+	bool input(InputConfig* config, Input input) override;
+	void update(int deltaTime) override;
+	void onSizeChanged() override;
+	std::vector<HelpPrompt> getHelpPrompts() override;
+
+private:
+	void updateResults();
+
+	NinePatchComponent mBackground;
+	ComponentGrid mGrid;
+
+	std::shared_ptr<TextComponent> mTitle;
+	std::shared_ptr<TextEditComponent> mText;
+	std::shared_ptr<ComponentList> mList;
+
+	SystemData* mSystem;
+	std::string mQuery;
+};
+
+#endif // ES_APP_GUIS_GUI_GAME_SEARCH_H
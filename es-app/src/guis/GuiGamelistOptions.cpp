@@ -1,5 +1,6 @@
 #include "GuiGamelistOptions.h"
 
+#include "guis/GuiGameSearch.h"
 #include "guis/GuiGamelistFilter.h"
 #include "scrapers/Scraper.h"
 #include "views/gamelist/IGameListView.h"
@@ -44,19 +45,14 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) : Gui
 			}
 
 			mJumpToLetterList = std::make_shared<LetterList>(mWindow, "JUMP TO ...", false);
+			FileData* folder = getGamelist()->getCursor()->getParent();
 			for (char c = startChar; c <= endChar; c++)
 			{
 				// check if c is a valid first letter in current list
-				const std::vector<FileData*>& files = getGamelist()->getCursor()->getParent()->getChildrenListToDisplay();
-				for (auto file : files)
+				if (folder->getFirstLetterPosition(c) != -1)
 				{
-					char candidate = (char)toupper(file->getSortName()[0]);
-					if (c == candidate)
-					{
-						mJumpToLetterList->add(std::string(1, c), c, (c == curChar) || outOfRange);
-						outOfRange = false; // only override selection on very first c == candidate match
-						break;
-					}
+					mJumpToLetterList->add(std::string(1, c), c, (c == curChar) || outOfRange);
+					outOfRange = false; // only override selection on very first c == candidate match
 				}
 			}
 
@@ -77,6 +73,12 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) : Gui
 			mMenu.addRow(row);
 		}
 
+		row.elements.clear();
+		row.addElement(std::make_shared<TextComponent>(mWindow, "SEARCH", Font::get(FONT_SIZE_MEDIUM), 0x777777FF), true);
+		row.addElement(makeArrow(mWindow), false);
+		row.makeAcceptInputHandler(std::bind(&GuiGamelistOptions::openSearch, this));
+		mMenu.addRow(row);
+
 		// add launch system screensaver
 		std::string screensaver_behavior = Settings::getInstance()->getString("ScreenSaverBehavior");
 		bool useGamelistMedia = screensaver_behavior == "random video" || (screensaver_behavior == "slideshow" && !Settings::getInstance()->getBool("SlideshowScreenSaverCustomMediaSource"));
@@ -208,6 +210,12 @@ void GuiGamelistOptions::openGamelistFilter()
 	mWindow->pushGui(ggf);
 }
 
+void GuiGamelistOptions::openSearch()
+{
+	mWindow->pushGui(new GuiGameSearch(mWindow, mSystem));
+	delete this;
+}
+
 void GuiGamelistOptions::recreateCollection()
 {
 	CollectionSystemManager::get()->recreateCollection(mSystem);
@@ -255,6 +263,9 @@ void GuiGamelistOptions::openMetaDataEd()
 	saveBtnFunc = [this, file] {
 		ViewController::get()->getGameListView(mSystem)->setCursor(file, true);
 		mMetadataChanged = true;
+		// media may have been added or removed
+		file->getSystem()->invalidateMediaFlags();
+		mSystem->invalidateMediaFlags();
 		ViewController::get()->getGameListView(file->getSystem())->onFileChanged(file, FILE_METADATA_CHANGED);
 	};
 
@@ -278,33 +289,12 @@ void GuiGamelistOptions::jumpToLetter()
 {
 	char letter = mJumpToLetterList->getSelected();
 	IGameListView* gamelist = getGamelist();
+	FileData* folder = gamelist->getCursor()->getParent();
 
-	// this is a really shitty way to get a list of files
-	const std::vector<FileData*>& files = gamelist->getCursor()->getParent()->getChildrenListToDisplay();
-
-	long min = 0;
-	long max = (long)files.size() - 1;
-	long mid = 0;
-
-	while(max >= min)
-	{
-		mid = ((max - min) / 2) + min;
-
-		// game somehow has no first character to check
-		if(files.at(mid)->getName().empty())
-			continue;
-
-		char checkLetter = (char)toupper(files.at(mid)->getSortName()[0]);
-
-		if(checkLetter < letter)
-			min = mid + 1;
-		else if(checkLetter > letter || (mid > 0 && (letter == toupper(files.at(mid - 1)->getSortName()[0]))))
-			max = mid - 1;
-		else
-			break; //exact match found
-	}
-
-	gamelist->setCursor(files.at(mid));
+	// only letters present in the list are offered
+	const int position = folder->getFirstLetterPosition(letter);
+	if(position != -1)
+		gamelist->setCursor(folder->getChildrenListToDisplay().at(position));
 
 	// flag to force default sort order "name, asc", if user changed the sortorder in the options dialog
 	mJumpToSelected = true;
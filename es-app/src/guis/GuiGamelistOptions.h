@@ -22,6 +22,7 @@ public:
 
 private:
 	void openGamelistFilter();
+	void openSearch();
 	bool launchSystemScreenSaver();
 	void openMetaDataEd();
 	void startEditMode();
@@ -494,6 +494,30 @@ void GuiMenu::openOtherSettings()
 	s->addWithLabel("SHOW FRAMERATE", framerate);
 	s->addSaveFunc([framerate] { Settings::getInstance()->setBool("DrawFramerate", framerate->getState()); });
 
+	// skip idle frames
+	auto skip_idle = std::make_shared<SwitchComponent>(mWindow);
+	skip_idle->setState(Settings::getInstance()->getBool("SkipIdleFrames"));
+	s->addWithLabel("SKIP IDLE FRAMES", skip_idle);
+	s->addSaveFunc([skip_idle] { Settings::getInstance()->setBool("SkipIdleFrames", skip_idle->getState()); });
+
+	// texture cache
+	auto texture_cache = std::make_shared<SwitchComponent>(mWindow);
+	texture_cache->setState(Settings::getInstance()->getBool("TextureCache"));
+	s->addWithLabel("CACHE DECODED IMAGES", texture_cache);
+	s->addSaveFunc([texture_cache] { Settings::getInstance()->setBool("TextureCache", texture_cache->getState()); });
+
+	// texture atlas
+	auto texture_atlas = std::make_shared<SwitchComponent>(mWindow);
+	texture_atlas->setState(Settings::getInstance()->getBool("TextureAtlas"));
+	s->addWithLabel("PACK SMALL IMAGES TOGETHER", texture_atlas);
+	s->addSaveFunc([texture_atlas] { Settings::getInstance()->setBool("TextureAtlas", texture_atlas->getState()); });
+
+	// theme cache
+	auto theme_cache = std::make_shared<SwitchComponent>(mWindow);
+	theme_cache->setState(Settings::getInstance()->getBool("ThemeCache"));
+	s->addWithLabel("CACHE PARSED THEMES", theme_cache);
+	s->addSaveFunc([theme_cache] { Settings::getInstance()->setBool("ThemeCache", theme_cache->getState()); });
+
 
 	mWindow->pushGui(s);
 
@@ -5,12 +5,16 @@
 #include "components/ScraperSearchComponent.h"
 #include "components/TextComponent.h"
 #include "guis/GuiMsgBox.h"
+#include "scrapers/ScraperBatch.h"
 #include "views/ViewController.h"
 #include "Gamelist.h"
 #include "PowerSaver.h"
 #include "SystemData.h"
 #include "Window.h"
 
+// games accepted between two gamelist saves when approving results
+#define SCRAPER_MULTI_CHECKPOINT 100
+
 GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchParams>& searches, bool approveResults) :
 	GuiComponent(window), mBackground(window, ":/frame.png"), mGrid(window, Vector2i(1, 5)),
 	mSearchQueue(searches)
@@ -27,6 +31,8 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	mCurrentGame = 0;
 	mTotalSuccessful = 0;
 	mTotalSkipped = 0;
+	mTotalFailed = 0;
+	mCacheStats = HttpCache::getInstance().getStats();
 
 	// set up grid
 	mTitle = std::make_shared<TextComponent>(mWindow, "SCRAPING IN PROGRESS", Font::get(FONT_SIZE_LARGE), 0x555555FF, ALIGN_CENTER);
@@ -68,7 +74,18 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	setSize(Renderer::getScreenWidth() * 0.95f, Renderer::getScreenHeight() * 0.849f);
 	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
 
-	doNextSearch();
+	if(approveResults)
+	{
+		doNextSearch();
+	}else{
+		mBatch = std::unique_ptr<ScraperBatch>(new ScraperBatch(mSearchQueue));
+		mBatch->setGameDoneCallback(std::bind(&GuiScraperMulti::onBatchGameDone, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+
+		mSystem->setText(Utils::String::toUpper(mSearchQueue.front().system->getFullName()));
+		std::stringstream ss;
+		ss << "GAME 0 OF " << mTotalGames;
+		mSubtitle->setText(ss.str());
+	}
 }
 
 GuiScraperMulti::~GuiScraperMulti()
@@ -89,6 +106,40 @@ void GuiScraperMulti::onSizeChanged()
 	mGrid.setSize(mSize);
 }
 
+void GuiScraperMulti::update(int deltaTime)
+{
+	GuiComponent::update(deltaTime);
+
+	if(mBatch)
+	{
+		mBatch->update();
+
+		if(mBatch->isDone())
+			finish();
+	}
+}
+
+bool GuiScraperMulti::isAnimating() const
+{
+	// the batch is only polled from update(), keep updating until it is done
+	if(mBatch)
+		return true;
+
+	return GuiComponent::isAnimating();
+}
+
+void GuiScraperMulti::onBatchGameDone(const ScraperSearchParams& params, const ScraperSearchResult* result, const std::string& /*error*/)
+{
+	std::stringstream ss;
+	mSystem->setText(Utils::String::toUpper(params.system->getFullName()));
+
+	ss << "GAME " << mBatch->getCompletedGames() << " OF " << mTotalGames << " - " << Utils::String::toUpper(Utils::FileSystem::getFileName(params.game->getPath()));
+	mSubtitle->setText(ss.str());
+
+	if(result)
+		mSearchComp->showResult(*result);
+}
+
 void GuiScraperMulti::doNextSearch()
 {
 	if(mSearchQueue.empty())
@@ -114,11 +165,17 @@ void GuiScraperMulti::acceptResult(const ScraperSearchResult& result)
 	ScraperSearchParams& search = mSearchQueue.front();
 
 	search.game->metadata = result.mdl;
-	updateGamelist(search.system);
+	search.game->getSystem()->invalidateMediaFlags();
+	search.game->getSourceFileData()->getSystem()->invalidateMediaFlags();
+	mUnsavedSystems.insert(search.system);
 
 	mSearchQueue.pop();
 	mCurrentGame++;
 	mTotalSuccessful++;
+
+	if(mTotalSuccessful % SCRAPER_MULTI_CHECKPOINT == 0)
+		saveGamelists();
+
 	doNextSearch();
 }
 
@@ -130,8 +187,27 @@ void GuiScraperMulti::skip()
 	doNextSearch();
 }
 
+void GuiScraperMulti::saveGamelists()
+{
+	for(auto it = mUnsavedSystems.cbegin(); it != mUnsavedSystems.cend(); it++)
+		updateGamelist(*it);
+
+	mUnsavedSystems.clear();
+}
+
 void GuiScraperMulti::finish()
 {
+	if(mBatch)
+	{
+		mBatch->stop();
+		mTotalSuccessful = mBatch->getTotalSuccessful();
+		mTotalSkipped = mBatch->getTotalSkipped();
+		mTotalFailed = mBatch->getTotalFailed();
+		mBatch.reset();
+	}
+
+	saveGamelists();
+
 	std::stringstream ss;
 	if(mTotalSuccessful == 0)
 	{
@@ -143,6 +219,15 @@ void GuiScraperMulti::finish()
 			ss << "\n" << mTotalSkipped << " GAME" << ((mTotalSkipped > 1) ? "S" : "") << " SKIPPED.";
 	}
 
+	if(mTotalFailed > 0)
+		ss << "\n" << mTotalFailed << " GAME" << ((mTotalFailed > 1) ? "S" : "") << " FAILED, SEE THE LOG.";
+
+	const HttpCache::Stats cacheStats = HttpCache::getInstance().getStats();
+	const unsigned int cacheHits = cacheStats.hits - mCacheStats.hits;
+	const unsigned int cacheMisses = cacheStats.misses - mCacheStats.misses;
+	if(cacheHits + cacheMisses > 0)
+		ss << "\nCACHE: " << cacheHits << " HIT" << ((cacheHits != 1) ? "S" : "") << ", " << cacheMisses << " MISS" << ((cacheMisses != 1) ? "ES" : "") << ".";
+
 	mWindow->pushGui(new GuiMsgBox(mWindow, ss.str(),
 		"OK", [&] { delete this; }));
 
@@ -6,7 +6,10 @@
 #include "components/NinePatchComponent.h"
 #include "scrapers/Scraper.h"
 #include "GuiComponent.h"
+#include "HttpCache.h"
+#include <set>
 
+class ScraperBatch;
 class ScraperSearchComponent;
 class TextComponent;
 
@@ -16,6 +19,8 @@ public:
 	GuiScraperMulti(Window* window, const std::queue<ScraperSearchParams>& searches, bool approveResults);
 	virtual ~GuiScraperMulti();
 
+	void update(int deltaTime) override;
+	bool isAnimating() const override;
 	void onSizeChanged() override;
 	std::vector<HelpPrompt> getHelpPrompts() override;
 
@@ -23,6 +28,9 @@ private:
 	void acceptResult(const ScraperSearchResult& result);
 	void skip();
 	void doNextSearch();
+	void saveGamelists();
+
+	void onBatchGameDone(const ScraperSearchParams& params, const ScraperSearchResult* result, const std::string& error);
 
 	void finish();
 
@@ -30,7 +38,14 @@ private:
 	unsigned int mCurrentGame;
 	unsigned int mTotalSuccessful;
 	unsigned int mTotalSkipped;
+	unsigned int mTotalFailed;
 	std::queue<ScraperSearchParams> mSearchQueue;
+	HttpCache::Stats mCacheStats; // when scraping started
+
+	// without approval the games are scraped by a batch, several at once
+	std::unique_ptr<ScraperBatch> mBatch;
+	// systems with games accepted since the last gamelist save
+	std::set<SystemData*> mUnsavedSystems;
 
 	NinePatchComponent mBackground;
 	ComponentGrid mGrid;
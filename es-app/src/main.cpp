@@ -5,10 +5,13 @@
 #include "guis/GuiMsgBox.h"
 #include "utils/FileSystemUtil.h"
 #include "utils/ProfilingUtil.h"
+#include "utils/StringUtil.h"
+#include "utils/TracingUtil.h"
 #include "views/ViewController.h"
 #include "CollectionSystemManager.h"
 #include "EmulationStation.h"
 #include "InputManager.h"
+#include "LocalArtIndex.h"
 #include "Log.h"
 #include "MameNames.h"
 #include "platform.h"
@@ -29,6 +32,7 @@
 #include <FreeImage.h>
 
 bool scrape_cmdline = false;
+ScraperCmdLineOptions scrape_options;
 
 bool parseArgs(int argc, char* argv[])
 {
@@ -153,6 +157,29 @@ bool parseArgs(int argc, char* argv[])
 		}else if(strcmp(argv[i], "--scrape") == 0)
 		{
 			scrape_cmdline = true;
+		}else if(strcmp(argv[i], "--scrape-systems") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "Invalid systems supplied.";
+				return false;
+			}
+
+			scrape_options.systems = Utils::String::delimitedStringToVector(argv[i + 1], ",");
+			i++; // skip the systems
+		}else if(strcmp(argv[i], "--scrape-all") == 0)
+		{
+			scrape_options.all = true;
+		}else if(strcmp(argv[i], "--scrape-searches") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "Invalid number of searches supplied.";
+				return false;
+			}
+
+			scrape_options.maxSearches = (unsigned int)atoi(argv[i + 1]);
+			i++; // skip the number
 		}else if(strcmp(argv[i], "--max-vram") == 0)
 		{
 			int maxVRAM = atoi(argv[i + 1]);
@@ -170,6 +197,18 @@ bool parseArgs(int argc, char* argv[])
 		{
 			Settings::getInstance()->setBool("ForceDisableFilters", true);
 		}
+		else if (strcmp(argv[i], "--trace") == 0)
+		{
+			if(i >= argc - 1)
+			{
+				std::cerr << "Invalid trace file supplied.";
+				return false;
+			}
+
+			Utils::Tracing::start(argv[i + 1]);
+			Utils::Tracing::setThreadName("main");
+			i++; // skip the file
+		}
 		else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
 		{
 #ifdef WIN32
@@ -220,13 +259,23 @@ bool parseArgs(int argc, char* argv[])
 				"--show-hidden-files            show also hidden files of filesystem, no effect\n"
 				"                               if --gamelist-only is also set (p)\n"
 				"--vsync 1|0                    turn vsync on (1) or off (0) (default is on)\n"
+				"--trace FILE                   record a timeline of startup, loading and\n"
+				"                               frames, written to FILE on exit. Open it in\n"
+				"                               chrome://tracing or ui.perfetto.dev\n"
 				"\nGeneric switches:\n"
 				"--help, -h                     summon a sentient, angry tuba\n\n"
 				"--home PATH                    directory to use as home folder for\n"
 				"                               .emulationstation/es_settings.cfg, aso.\n"
 				"                               Subfolder .emulationstation/ will be created.\n"
 				"\nScrape mode:\n"
-				"--scrape                       scrape using command line interface\n\n"
+				"--scrape                       scrape without any interaction, the progress\n"
+				"                               is written to stdout as JSON lines. A run\n"
+				"                               that was stopped continues where it was\n"
+				"--scrape-systems NAME,NAME     only scrape these systems (default: all the\n"
+				"                               systems with a platform set)\n"
+				"--scrape-all                   also scrape games that have an image already\n"
+				"--scrape-searches N            searches at the same time (default: as many\n"
+				"                               as the scraper's service allows)\n\n"
 				"Note: Switches marked (p) will be persisted in es_settings.cfg when any\n"
 				"setting is changed via EmulationStation UI.\n\n"
 				"Please refer to the online documentation for additional information:\n"
@@ -286,6 +335,7 @@ bool loadSystemConfigFile(Window* window, const char** errorString)
 //called on exit, assuming we get far enough to have the log initialized
 void onExit()
 {
+	Utils::Tracing::write();
 	Log::close();
 }
 
@@ -372,7 +422,7 @@ int main(int argc, char* argv[])
 	}
 
 	const char* errorMsg = NULL;
-	if(!loadSystemConfigFile(splashScreen ? &window : nullptr, &errorMsg))
+	if(!loadSystemConfigFile((splashScreen && !scrape_cmdline) ? &window : nullptr, &errorMsg))
 	{
 		// something went terribly wrong
 		if(errorMsg == NULL)
@@ -396,11 +446,10 @@ int main(int argc, char* argv[])
 	//run the command line scraper then quit
 	if(scrape_cmdline)
 	{
-		return run_scraper_cmdline();
+		return run_scraper_cmdline(scrape_options);
 	}
 
-	// preload what we can right away instead of waiting for the user to select it
-	// this makes for no delays when accessing content, but a longer startup time
+	// gamelist views are built as navigation gets close to them, so startup time no longer grows with the number of systems
 	ViewController::get()->preload();
 
 	if(splashScreen)
@@ -469,9 +518,24 @@ int main(int argc, char* argv[])
 		if(deltaTime < 0)
 			deltaTime = 1000;
 
-		window.update(deltaTime);
-		window.render();
-		Renderer::swapBuffers();
+		LocalArtIndex::pollChanges();
+
+		{
+			TraceScope("Window::update");
+			window.update(deltaTime);
+		}
+
+		if(window.isIdle())
+		{
+			// nothing changed on screen, wait for input instead of drawing the same frame again
+			SDL_WaitEventTimeout(NULL, window.getIdleTimeout());
+		}
+		else
+		{
+			TraceScope("Window::render");
+			window.render();
+			Renderer::swapBuffers();
+		}
 
 		Log::flush();
 	}
@@ -482,9 +546,10 @@ int main(int argc, char* argv[])
 	InputManager::getInstance()->deinit();
 	window.deinit();
 
-	MameNames::deinit();
 	CollectionSystemManager::deinit();
 	SystemData::deleteSystems();
+	// deleting the systems saves their gamelists, which uses the display names held by MameNames
+	MameNames::deinit();
 
 	// call this ONLY when linking with FreeImage as a static library
 #ifdef FREEIMAGE_LIB
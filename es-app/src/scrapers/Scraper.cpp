@@ -6,14 +6,31 @@
 #include "Log.h"
 #include "Settings.h"
 #include "SystemData.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/TracingUtil.h"
 #include <FreeImage.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <math.h>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
 
 const std::map<std::string, generate_scraper_requests_func> scraper_request_funcs {
 	{ "TheGamesDB", &thegamesdb_generate_json_scraper_requests },
 	{ "ScreenScraper", &screenscraper_generate_scraper_requests }
 };
 
+// TheGamesDB counts requests against a monthly allowance per API key rather than limiting concurrency.
+// ScreenScraper only grants one thread to accounts without a higher contribution level.
+const std::map<std::string, ScraperLimits> scraper_limits {
+	{ "TheGamesDB", { 4, 250 } },
+	{ "ScreenScraper", { 1, 1000 } }
+};
+
 std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParams& params)
 {
 	const std::string& name = Settings::getInstance()->getString("Scraper");
@@ -49,6 +66,18 @@ bool isValidConfiguredScraper()
 	return scraper_request_funcs.find(name) != scraper_request_funcs.end();
 }
 
+ScraperLimits getScraperLimits()
+{
+	const std::string& name = Settings::getInstance()->getString("Scraper");
+	auto it = scraper_limits.find(name);
+	if(it != scraper_limits.cend())
+		return it->second;
+
+	// unknown scraper, one search at a time like before
+	ScraperLimits limits = { 1, 0 };
+	return limits;
+}
+
 // ScraperSearchHandle
 ScraperSearchHandle::ScraperSearchHandle()
 {
@@ -109,7 +138,7 @@ ScraperHttpRequest::ScraperHttpRequest(std::vector<ScraperSearchResult>& results
 	: ScraperRequest(resultsWrite)
 {
 	setStatus(ASYNC_IN_PROGRESS);
-	mReq = std::unique_ptr<HttpReq>(new HttpReq(url));
+	mReq = std::unique_ptr<HttpReq>(new HttpReq(url, "", true));
 }
 
 void ScraperHttpRequest::update()
@@ -193,19 +222,136 @@ void MDResolveHandle::update()
 		setStatus(ASYNC_DONE);
 }
 
+// a downloaded image waiting to be resized and written, shared with the image thread
+class ImageResizeJob
+{
+public:
+	ImageResizeJob(const std::string& _data, const std::string& _path, int _maxWidth, int _maxHeight) :
+		data(_data), path(_path), maxWidth(_maxWidth), maxHeight(_maxHeight), status(ASYNC_IN_PROGRESS) {}
+
+	std::string data;
+	std::string path;
+	int maxWidth;
+	int maxHeight;
+
+	std::atomic<AsyncHandleStatus> status;
+};
+
+// Decodes, resizes and encodes scraped images so the UI doesn't wait on them.
+class ImageResizeThread
+{
+public:
+	static ImageResizeThread& getInstance()
+	{
+		static ImageResizeThread instance;
+		return instance;
+	}
+
+	~ImageResizeThread()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mRunning = false;
+		}
+		mCondition.notify_one();
+		mThread.join();
+	}
+
+	void queue(const std::shared_ptr<ImageResizeJob>& job)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobs.push_back(job);
+		}
+		mCondition.notify_one();
+	}
+
+private:
+	ImageResizeThread() : mRunning(true)
+	{
+		mThread = std::thread(&ImageResizeThread::run, this);
+	}
+
+	void run()
+	{
+		Utils::Tracing::setThreadName("image resize");
+
+		while(true)
+		{
+			std::shared_ptr<ImageResizeJob> job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				while(mRunning && mJobs.empty())
+					mCondition.wait(lock);
+
+				if(!mRunning)
+					return;
+
+				job = mJobs.front();
+				mJobs.pop_front();
+			}
+
+			// nobody is waiting for it anymore, the scrape was stopped
+			if(job.use_count() == 1)
+				continue;
+
+			TraceScopeArg("ImageResizeThread::resize", job->path);
+			const bool resized = resizeImage((const unsigned char*)job->data.data(), job->data.size(), job->path, job->maxWidth, job->maxHeight);
+			job->data.clear();
+			job->status.store(resized ? ASYNC_DONE : ASYNC_ERROR);
+		}
+	}
+
+	std::thread mThread;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque< std::shared_ptr<ImageResizeJob> > mJobs;
+	bool mRunning;
+};
+
 std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url, const std::string& saveAs)
 {
 	return std::unique_ptr<ImageDownloadHandle>(new ImageDownloadHandle(url, saveAs,
 		Settings::getInstance()->getInt("ScraperResizeWidth"), Settings::getInstance()->getInt("ScraperResizeHeight")));
 }
 
+// images are written next to their path first so an interrupted save never leaves a truncated one behind
+static bool replaceWithTemp(const std::string& tempPath, const std::string& path)
+{
+#if defined(_WIN32)
+	// rename doesn't replace an existing file on windows
+	Utils::FileSystem::removeFile(path);
+#endif
+
+	if(rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		Utils::FileSystem::removeFile(tempPath);
+		return false;
+	}
+
+	return true;
+}
+
 ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight) :
-	mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight), mReq(new HttpReq(url))
+	mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight),
+	// an image that gets resized is kept in memory so the file is only written once, resized,
+	// any other is downloaded next to its path so a failed download leaves the old one alone
+	mReq(new HttpReq(url, (maxWidth == 0 && maxHeight == 0) ? path + ".tmp" : "", true))
 {
 }
 
 void ImageDownloadHandle::update()
 {
+	if(mResize)
+	{
+		const AsyncHandleStatus status = mResize->status.load();
+		if(status == ASYNC_ERROR)
+			setError("Error saving resized image. Out of memory? Disk full?");
+		else if(status == ASYNC_DONE)
+			setStatus(ASYNC_DONE);
+		return;
+	}
+
 	if(mReq->status() == HttpReq::REQ_IN_PROGRESS)
 		return;
 
@@ -217,31 +363,36 @@ void ImageDownloadHandle::update()
 		return;
 	}
 
-	// download is done, save it to disk
-	std::ofstream stream(mSavePath, std::ios_base::out | std::ios_base::binary);
-	if(stream.bad())
+	// download is done and written to disk by the request
+	if(mMaxWidth == 0 && mMaxHeight == 0)
 	{
-		setError("Failed to open image path to write. Permission error? Disk full?");
+		if(replaceWithTemp(mSavePath + ".tmp", mSavePath))
+			setStatus(ASYNC_DONE);
+		else
+			setError("Error saving image. Disk full?");
 		return;
 	}
 
-	const std::string& content = mReq->getContent();
-	stream.write(content.data(), content.length());
-	stream.close();
-	if(stream.bad())
-	{
-		setError("Failed to save image. Disk full?");
-		return;
-	}
+	mResize = std::make_shared<ImageResizeJob>(mReq->getContent(), mSavePath, mMaxWidth, mMaxHeight);
+	mReq.reset();
+	ImageResizeThread::getInstance().queue(mResize);
+}
+
+ImageDownloadHandle::~ImageDownloadHandle()
+{
+}
 
-	// resize it
-	if(!resizeImage(mSavePath, mMaxWidth, mMaxHeight))
+static bool saveImage(FREE_IMAGE_FORMAT format, FIBITMAP* image, const std::string& path)
+{
+	const std::string tempPath = path + ".tmp";
+
+	if(!FreeImage_Save(format, image, tempPath.c_str()))
 	{
-		setError("Error saving resized image. Out of memory? Disk full?");
-		return;
+		Utils::FileSystem::removeFile(tempPath);
+		return false;
 	}
 
-	setStatus(ASYNC_DONE);
+	return replaceWithTemp(tempPath, path);
 }
 
 //you can pass 0 for width or height to keep aspect ratio
@@ -251,25 +402,94 @@ bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
 	if(maxWidth == 0 && maxHeight == 0)
 		return true;
 
-	FREE_IMAGE_FORMAT format = FIF_UNKNOWN;
-	FIBITMAP* image = NULL;
+	std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+	if(!stream.is_open())
+	{
+		LOG(LogError) << "Error - could not open image \"" << path << "\"!";
+		return false;
+	}
+
+	const std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	stream.close();
+
+	return resizeImage((const unsigned char*)data.data(), data.size(), path, maxWidth, maxHeight);
+}
+
+bool resizeImage(const unsigned char* data, const size_t size, const std::string& path, int maxWidth, int maxHeight)
+{
+	// nothing to resize, only save it
+	if(maxWidth == 0 && maxHeight == 0)
+	{
+		const std::string tempPath = path + ".tmp";
+		std::ofstream stream(tempPath, std::ios_base::out | std::ios_base::binary);
+		stream.write((const char*)data, size);
+		stream.close();
+		if(stream.fail())
+		{
+			Utils::FileSystem::removeFile(tempPath);
+			return false;
+		}
+
+		return replaceWithTemp(tempPath, path);
+	}
+
+	FIMEMORY* memory = FreeImage_OpenMemory((BYTE*)data, (DWORD)size);
+	if(memory == NULL)
+	{
+		LOG(LogError) << "Error - could not read image \"" << path << "\"!";
+		return false;
+	}
 
 	//detect the filetype
-	format = FreeImage_GetFileType(path.c_str(), 0);
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(memory);
 	if(format == FIF_UNKNOWN)
 		format = FreeImage_GetFIFFromFilename(path.c_str());
 	if(format == FIF_UNKNOWN)
 	{
 		LOG(LogError) << "Error - could not detect filetype for image \"" << path << "\"!";
+		FreeImage_CloseMemory(memory);
 		return false;
 	}
 
-	//make sure we can read this filetype first, then load it
-	if(FreeImage_FIFSupportsReading(format))
+	//make sure we can read this filetype first
+	if(!FreeImage_FIFSupportsReading(format))
 	{
-		image = FreeImage_Load(format, path.c_str());
-	}else{
 		LOG(LogError) << "Error - file format reading not supported for image \"" << path << "\"!";
+		FreeImage_CloseMemory(memory);
+		return false;
+	}
+
+	//jpeg can be decoded at 1/2, 1/4 or 1/8 of its size, ask for the smallest that still covers the target size.
+	//the decoder is given the size of the larger side
+	int flags = 0;
+	if(format == FIF_JPEG)
+	{
+		FIBITMAP* header = FreeImage_LoadFromMemory(format, memory, FIF_LOAD_NOPIXELS);
+		if(header != NULL)
+		{
+			const float width = (float)FreeImage_GetWidth(header);
+			const float height = (float)FreeImage_GetHeight(header);
+			FreeImage_Unload(header);
+
+			if(width > 0 && height > 0)
+			{
+				const float targetWidth = (maxWidth == 0) ? ((maxHeight / height) * width) : (float)maxWidth;
+				const float targetHeight = (maxHeight == 0) ? ((maxWidth / width) * height) : (float)maxHeight;
+				const float scale = std::max(targetWidth / width, targetHeight / height);
+
+				if(scale < 1.0f)
+					flags = (int)ceilf(std::max(width, height) * scale) << 16;
+			}
+		}
+		FreeImage_SeekMemory(memory, 0, SEEK_SET);
+	}
+
+	FIBITMAP* image = FreeImage_LoadFromMemory(format, memory, flags);
+	FreeImage_CloseMemory(memory);
+
+	if(image == NULL)
+	{
+		LOG(LogError) << "Error - could not decode image \"" << path << "\"!";
 		return false;
 	}
 
@@ -293,7 +513,7 @@ bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
 		return false;
 	}
 
-	bool saved = (FreeImage_Save(format, imageRescaled, path.c_str()) != 0);
+	bool saved = saveImage(format, imageRescaled, path);
 	FreeImage_Unload(imageRescaled);
 
 	if(!saved)
@@ -116,6 +116,16 @@ std::vector<std::string> getScraperList();
 // returns true if the scraper configured in the settings is still valid
 bool isValidConfiguredScraper();
 
+// how hard a scraper's service may be used, from the terms of each service
+struct ScraperLimits
+{
+	unsigned int maxSearches;      // searches in flight at the same time
+	unsigned int searchIntervalMs; // minimum time between the start of two searches
+};
+
+// returns the limits of the scraper configured in the settings
+ScraperLimits getScraperLimits();
+
 typedef void (*generate_scraper_requests_func)(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, std::vector<ScraperSearchResult>& results);
 
 // -------------------------------------------------------------------------
@@ -138,15 +148,19 @@ private:
 	std::vector<ResolvePair> mFuncs;
 };
 
+class ImageResizeJob;
+
 class ImageDownloadHandle : public AsyncHandle
 {
 public:
 	ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight);
+	~ImageDownloadHandle();
 
 	void update() override;
 
 private:
 	std::unique_ptr<HttpReq> mReq;
+	std::shared_ptr<ImageResizeJob> mResize; // set once downloaded, the image is resized off the UI thread
 	std::string mSavePath;
 	int mMaxWidth;
 	int mMaxHeight;
@@ -167,4 +181,8 @@ std::unique_ptr<MDResolveHandle> resolveMetaDataAssets(const ScraperSearchResult
 //Returns true if successful, false otherwise.
 bool resizeImage(const std::string& path, int maxWidth, int maxHeight);
 
+//As above, from an image in memory which is written to [path] once resized.
+//Safe to call from any thread.
+bool resizeImage(const unsigned char* data, const size_t size, const std::string& path, int maxWidth, int maxHeight);
+
 #endif // ES_APP_SCRAPERS_SCRAPER_H
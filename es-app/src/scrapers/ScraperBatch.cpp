@@ -0,0 +1,207 @@
+#include "scrapers/ScraperBatch.h"
+
+#include "FileData.h"
+#include "FileFilterIndex.h"
+#include "Gamelist.h"
+#include "Log.h"
+#include "Settings.h"
+#include "SystemData.h"
+#include <SDL_timer.h>
+
+// media downloads in flight at the same time, they are not limited by the scraper's terms
+#define SCRAPER_BATCH_MAX_DOWNLOADS 4
+// games scraped between two gamelist saves, so little is lost if ES is killed
+#define SCRAPER_BATCH_CHECKPOINT 100
+
+ScraperBatch::ScraperBatch(const std::queue<ScraperSearchParams>& searches) : mLimits(getScraperLimits()), mLastSearchTime(0),
+	mSearchQueue(searches), mUnsavedGames(0), mTotalGames((unsigned int)searches.size()), mTotalSuccessful(0), mTotalSkipped(0), mTotalFailed(0)
+{
+	if(mLimits.maxSearches == 0)
+		mLimits.maxSearches = 1;
+
+	if(!isValidConfiguredScraper())
+	{
+		LOG(LogError) << "Configured scraper (" << Settings::getInstance()->getString("Scraper") << ") unavailable, scraping aborted.";
+		mTotalFailed = mTotalGames;
+		while(!mSearchQueue.empty())
+			mSearchQueue.pop();
+	}
+}
+
+ScraperBatch::~ScraperBatch()
+{
+	save();
+}
+
+void ScraperBatch::update()
+{
+	updateSearches();
+	updateResolves();
+
+	startSearches();
+	startResolves();
+
+	if(mUnsavedGames >= SCRAPER_BATCH_CHECKPOINT || (isDone() && !mUnsavedSystems.empty()))
+		save();
+}
+
+void ScraperBatch::stop()
+{
+	while(!mSearchQueue.empty())
+		mSearchQueue.pop();
+
+	mSearches.clear();
+	mResolves.clear();
+
+	save();
+}
+
+void ScraperBatch::save()
+{
+	for(auto it = mUnsavedSystems.cbegin(); it != mUnsavedSystems.cend(); it++)
+		updateGamelist(*it);
+
+	mUnsavedSystems.clear();
+	mUnsavedGames = 0;
+
+	if(mSavedCallback)
+		mSavedCallback();
+}
+
+void ScraperBatch::startSearches()
+{
+	while(!mSearchQueue.empty() && mSearches.size() < mLimits.maxSearches)
+	{
+		const unsigned int now = SDL_GetTicks();
+		if(mLastSearchTime != 0 && now - mLastSearchTime < mLimits.searchIntervalMs)
+			return;
+
+		mLastSearchTime = now;
+
+		Search search;
+		search.params = mSearchQueue.front();
+		search.handle = startScraperSearch(search.params);
+		mSearches.push_back(std::move(search));
+		mSearchQueue.pop();
+	}
+}
+
+void ScraperBatch::startResolves()
+{
+	unsigned int running = 0;
+	for(auto it = mResolves.begin(); it != mResolves.end(); it++)
+	{
+		if(!it->handle)
+		{
+			if(running >= SCRAPER_BATCH_MAX_DOWNLOADS)
+				return;
+
+			it->handle = resolveMetaDataAssets(it->result, it->params);
+		}
+
+		running++;
+	}
+}
+
+void ScraperBatch::updateSearches()
+{
+	auto it = mSearches.begin();
+	while(it != mSearches.end())
+	{
+		const AsyncHandleStatus status = it->handle->status();
+		if(status == ASYNC_IN_PROGRESS)
+		{
+			it++;
+			continue;
+		}
+
+		if(status == ASYNC_ERROR)
+		{
+			fail(it->params, it->handle->getStatusString());
+		}
+		else if(it->handle->getResults().empty())
+		{
+			skip(it->params);
+		}
+		else
+		{
+			const ScraperSearchResult& result = it->handle->getResults().front();
+
+			// the media is downloaded separately so a slow download doesn't hold up the next search
+			if(!result.imageUrl.empty())
+			{
+				Resolve resolve;
+				resolve.params = it->params;
+				resolve.result = result;
+				mResolves.push_back(std::move(resolve));
+			}
+			else
+			{
+				accept(it->params, result);
+			}
+		}
+
+		it = mSearches.erase(it);
+	}
+}
+
+void ScraperBatch::updateResolves()
+{
+	auto it = mResolves.begin();
+	while(it != mResolves.end())
+	{
+		if(!it->handle)
+		{
+			it++;
+			continue;
+		}
+
+		const AsyncHandleStatus status = it->handle->status();
+		if(status == ASYNC_IN_PROGRESS)
+		{
+			it++;
+			continue;
+		}
+
+		if(status == ASYNC_ERROR)
+			fail(it->params, it->handle->getStatusString());
+		else
+			accept(it->params, it->handle->getResult());
+
+		it = mResolves.erase(it);
+	}
+}
+
+void ScraperBatch::accept(const ScraperSearchParams& params, const ScraperSearchResult& result)
+{
+	// the filters and the search index have to see the new metadata
+	params.game->getSystem()->getIndex()->removeFromIndex(params.game);
+	params.game->metadata = result.mdl;
+	params.game->getSystem()->getIndex()->addToIndex(params.game);
+	params.game->getSystem()->invalidateMediaFlags();
+	params.game->getSourceFileData()->getSystem()->invalidateMediaFlags();
+	mUnsavedSystems.insert(params.system);
+	mUnsavedGames++;
+	mTotalSuccessful++;
+
+	if(mGameDoneCallback)
+		mGameDoneCallback(params, &result, "");
+}
+
+void ScraperBatch::skip(const ScraperSearchParams& params)
+{
+	LOG(LogInfo) << "No results when scraping " << params.game->getPath();
+	mTotalSkipped++;
+
+	if(mGameDoneCallback)
+		mGameDoneCallback(params, nullptr, "");
+}
+
+void ScraperBatch::fail(const ScraperSearchParams& params, const std::string& error)
+{
+	LOG(LogWarning) << "Error scraping " << params.game->getPath() << ": " << error;
+	mTotalFailed++;
+
+	if(mGameDoneCallback)
+		mGameDoneCallback(params, nullptr, error);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef ES_APP_SCRAPERS_SCRAPER_BATCH_H
+#define ES_APP_SCRAPERS_SCRAPER_BATCH_H
+
+#include "scrapers/Scraper.h"
+#include <functional>
+#include <list>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+
+// Scrapes a list of games accepting the first result of each. Several searches are in flight
+// at once, within the limits of the configured scraper, and the media of accepted results is
+// downloaded by a separate bounded set of requests. Gamelists are written once per system,
+// at checkpoints and when the batch is done, instead of after every game.
+// Everything happens in update(), which must be called regularly from the main thread.
+class ScraperBatch
+{
+public:
+	ScraperBatch(const std::queue<ScraperSearchParams>& searches);
+	~ScraperBatch(); // saves the gamelists of the games scraped so far
+
+	void update();
+
+	// drops the games in flight and those not started yet, and saves what was scraped
+	void stop();
+
+	inline bool isDone() const { return mSearchQueue.empty() && mSearches.empty() && mResolves.empty(); }
+
+	inline unsigned int getTotalGames() const { return mTotalGames; }
+	inline unsigned int getCompletedGames() const { return mTotalSuccessful + mTotalSkipped + mTotalFailed; }
+	inline unsigned int getTotalSuccessful() const { return mTotalSuccessful; }
+	inline unsigned int getTotalSkipped() const { return mTotalSkipped; }
+	inline unsigned int getTotalFailed() const { return mTotalFailed; }
+
+	// called each time a game is done, result is nullptr if it was skipped or failed, error is only set if it failed
+	inline void setGameDoneCallback(const std::function<void(const ScraperSearchParams&, const ScraperSearchResult*, const std::string&)>& callback) { mGameDoneCallback = callback; }
+
+	// called after the gamelists were written, every game reported done so far is saved
+	inline void setSavedCallback(const std::function<void()>& callback) { mSavedCallback = callback; }
+
+	// searches in flight at the same time, instead of the limit of the scraper
+	inline void setMaxSearches(unsigned int maxSearches) { if(maxSearches > 0) mLimits.maxSearches = maxSearches; }
+
+	// writes the gamelists of the systems with scraped games
+	void save();
+
+private:
+	struct Search
+	{
+		ScraperSearchParams params;
+		std::unique_ptr<ScraperSearchHandle> handle;
+	};
+
+	struct Resolve
+	{
+		ScraperSearchParams params;
+		ScraperSearchResult result;
+		std::unique_ptr<MDResolveHandle> handle; // empty until a download slot is free
+	};
+
+	void startSearches();
+	void startResolves();
+	void updateSearches();
+	void updateResolves();
+
+	void accept(const ScraperSearchParams& params, const ScraperSearchResult& result);
+	void skip(const ScraperSearchParams& params);
+	void fail(const ScraperSearchParams& params, const std::string& error);
+
+	ScraperLimits mLimits;
+	unsigned int mLastSearchTime;
+
+	std::queue<ScraperSearchParams> mSearchQueue;
+	std::list<Search> mSearches;
+	std::list<Resolve> mResolves;
+	std::set<SystemData*> mUnsavedSystems;
+	unsigned int mUnsavedGames;
+
+	unsigned int mTotalGames;
+	unsigned int mTotalSuccessful;
+	unsigned int mTotalSkipped;
+	unsigned int mTotalFailed;
+
+	std::function<void(const ScraperSearchParams&, const ScraperSearchResult*, const std::string&)> mGameDoneCallback;
+	std::function<void()> mSavedCallback;
+};
+
+#endif // ES_APP_SCRAPERS_SCRAPER_BATCH_H
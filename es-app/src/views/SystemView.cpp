@@ -48,8 +48,8 @@ void SystemView::populate()
 			const ThemeData::ThemeElement* logoElem = theme->getElement("system", "logo", "image");
 			if(logoElem)
 			{
-				std::string path = logoElem->get<std::string>("path");
-				std::string defaultPath = logoElem->has("default") ? logoElem->get<std::string>("default") : "";
+				std::string path = logoElem->get<std::string>(ThemeProperty::PATH);
+				std::string defaultPath = logoElem->has(ThemeProperty::DEFAULT) ? logoElem->get<std::string>(ThemeProperty::DEFAULT) : "";
 				if((!path.empty() && ResourceManager::getInstance()->fileExists(path))
 				   || (!defaultPath.empty() && ResourceManager::getInstance()->fileExists(defaultPath)))
 				{
@@ -707,66 +707,66 @@ void  SystemView::getDefaultElements(void)
 
 void SystemView::getCarouselFromTheme(const ThemeData::ThemeElement* elem)
 {
-	if (elem->has("type"))
+	if (elem->has(ThemeProperty::TYPE))
 	{
-		if (!(elem->get<std::string>("type").compare("vertical")))
+		if (!(elem->get<std::string>(ThemeProperty::TYPE).compare("vertical")))
 			mCarousel.type = VERTICAL;
-		else if (!(elem->get<std::string>("type").compare("vertical_wheel")))
+		else if (!(elem->get<std::string>(ThemeProperty::TYPE).compare("vertical_wheel")))
 			mCarousel.type = VERTICAL_WHEEL;
-		else if (!(elem->get<std::string>("type").compare("horizontal_wheel")))
+		else if (!(elem->get<std::string>(ThemeProperty::TYPE).compare("horizontal_wheel")))
 			mCarousel.type = HORIZONTAL_WHEEL;
 		else
 			mCarousel.type = HORIZONTAL;
 	}
-	if (elem->has("size"))
-		mCarousel.size = elem->get<Vector2f>("size") * mSize;
-	if (elem->has("pos"))
-		mCarousel.pos = elem->get<Vector2f>("pos") * mSize;
-	if (elem->has("origin"))
-		mCarousel.origin = elem->get<Vector2f>("origin");
-	if (elem->has("color"))
+	if (elem->has(ThemeProperty::SIZE))
+		mCarousel.size = elem->get<Vector2f>(ThemeProperty::SIZE) * mSize;
+	if (elem->has(ThemeProperty::POS))
+		mCarousel.pos = elem->get<Vector2f>(ThemeProperty::POS) * mSize;
+	if (elem->has(ThemeProperty::ORIGIN))
+		mCarousel.origin = elem->get<Vector2f>(ThemeProperty::ORIGIN);
+	if (elem->has(ThemeProperty::COLOR))
 	{
-		mCarousel.color = elem->get<unsigned int>("color");
+		mCarousel.color = elem->get<unsigned int>(ThemeProperty::COLOR);
 		mCarousel.colorEnd = mCarousel.color;
 	}
-	if (elem->has("colorEnd"))
-		mCarousel.colorEnd = elem->get<unsigned int>("colorEnd");
-	if (elem->has("gradientType"))
-		mCarousel.colorGradientHorizontal = !(elem->get<std::string>("gradientType").compare("horizontal"));
-	if (elem->has("logoScale"))
-		mCarousel.logoScale = elem->get<float>("logoScale");
-	if (elem->has("logoSize"))
-		mCarousel.logoSize = elem->get<Vector2f>("logoSize") * mSize;
-	if (elem->has("maxLogoCount"))
-		mCarousel.maxLogoCount = (int)Math::round(elem->get<float>("maxLogoCount"));
-	if (elem->has("zIndex"))
-		mCarousel.zIndex = elem->get<float>("zIndex");
-	if (elem->has("logoRotation"))
-		mCarousel.logoRotation = elem->get<float>("logoRotation");
-	if (elem->has("logoRotationOrigin"))
-		mCarousel.logoRotationOrigin = elem->get<Vector2f>("logoRotationOrigin");
-	if (elem->has("logoAlignment"))
+	if (elem->has(ThemeProperty::COLOR_END))
+		mCarousel.colorEnd = elem->get<unsigned int>(ThemeProperty::COLOR_END);
+	if (elem->has(ThemeProperty::GRADIENT_TYPE))
+		mCarousel.colorGradientHorizontal = !(elem->get<std::string>(ThemeProperty::GRADIENT_TYPE).compare("horizontal"));
+	if (elem->has(ThemeProperty::LOGO_SCALE))
+		mCarousel.logoScale = elem->get<float>(ThemeProperty::LOGO_SCALE);
+	if (elem->has(ThemeProperty::LOGO_SIZE))
+		mCarousel.logoSize = elem->get<Vector2f>(ThemeProperty::LOGO_SIZE) * mSize;
+	if (elem->has(ThemeProperty::MAX_LOGO_COUNT))
+		mCarousel.maxLogoCount = (int)Math::round(elem->get<float>(ThemeProperty::MAX_LOGO_COUNT));
+	if (elem->has(ThemeProperty::Z_INDEX))
+		mCarousel.zIndex = elem->get<float>(ThemeProperty::Z_INDEX);
+	if (elem->has(ThemeProperty::LOGO_ROTATION))
+		mCarousel.logoRotation = elem->get<float>(ThemeProperty::LOGO_ROTATION);
+	if (elem->has(ThemeProperty::LOGO_ROTATION_ORIGIN))
+		mCarousel.logoRotationOrigin = elem->get<Vector2f>(ThemeProperty::LOGO_ROTATION_ORIGIN);
+	if (elem->has(ThemeProperty::LOGO_ALIGNMENT))
 	{
-		if (!(elem->get<std::string>("logoAlignment").compare("left")))
+		if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("left")))
 			mCarousel.logoAlignment = ALIGN_LEFT;
-		else if (!(elem->get<std::string>("logoAlignment").compare("right")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("right")))
 			mCarousel.logoAlignment = ALIGN_RIGHT;
-		else if (!(elem->get<std::string>("logoAlignment").compare("top")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("top")))
 			mCarousel.logoAlignment = ALIGN_TOP;
-		else if (!(elem->get<std::string>("logoAlignment").compare("bottom")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("bottom")))
 			mCarousel.logoAlignment = ALIGN_BOTTOM;
 		else
 			mCarousel.logoAlignment = ALIGN_CENTER;
 	}
-	if (elem->has("scrollSound"))
-		mScrollSound = elem->get<std::string>("scrollSound");
+	if (elem->has(ThemeProperty::SCROLL_SOUND))
+		mScrollSound = elem->get<std::string>(ThemeProperty::SCROLL_SOUND);
 
         // Read optional carousel extensions
-        if (elem->has("minLogoOpacity"))
-                mCarousel.minLogoOpacity = elem->get<float>("minLogoOpacity");
+        if (elem->has(ThemeProperty::MIN_LOGO_OPACITY))
+                mCarousel.minLogoOpacity = elem->get<float>(ThemeProperty::MIN_LOGO_OPACITY);
 
-        if (elem->has("scaledLogoSpacing"))
-                mCarousel.scaledLogoSpacing = elem->get<float>("scaledLogoSpacing");
+        if (elem->has(ThemeProperty::SCALED_LOGO_SPACING))
+                mCarousel.scaledLogoSpacing = elem->get<float>(ThemeProperty::SCALED_LOGO_SPACING);
 }
 
 void SystemView::onScroll(int amt)
@@ -5,6 +5,8 @@
 #include "animations/LaunchAnimation.h"
 #include "animations/MoveCameraAnimation.h"
 #include "guis/GuiMenu.h"
+#include "resources/TextureResource.h"
+#include "utils/TracingUtil.h"
 #include "views/gamelist/DetailedGameListView.h"
 #include "views/gamelist/IGameListView.h"
 #include "views/gamelist/GridGameListView.h"
@@ -18,6 +20,9 @@
 #include "SystemData.h"
 #include "Window.h"
 
+// gamelist views kept around besides the focused system and its neighbours
+#define GAMELIST_VIEW_CACHE_SIZE 8
+
 ViewController* ViewController::sInstance = NULL;
 
 ViewController* ViewController::get()
@@ -208,7 +213,7 @@ void ViewController::playViewTransition()
 			{
 				// right rollover
 				mLockInput = true;
-				tgt.x() = screenWidth * mGameListViews.size();
+				tgt.x() = screenWidth * SystemData::sSystemVector.size();
 			}
 			else if (-mCamera.translation().x() - tgt.x() <= 2 * -screenWidth)
 			{
@@ -249,6 +254,12 @@ void ViewController::playViewTransition()
 
 void ViewController::onFileChanged(FileData* file, FileChangeType change)
 {
+	if(change != FILE_SORTED)
+	{
+		file->getSystem()->invalidateMediaFlags();
+		file->getSourceFileData()->getSystem()->invalidateMediaFlags();
+	}
+
 	auto it = mGameListViews.find(file->getSystem());
 	if(it != mGameListViews.cend())
 		it->second->onFileChanged(file, change);
@@ -355,6 +366,8 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	if(exists != mGameListViews.cend())
 		return exists->second;
 
+	TraceScopeArg("ViewController::getGameListView", system->getName());
+
 	system->getIndex()->setUIModeFilters();
 	//if we didn't, make it, remember it, and return it
 	std::shared_ptr<IGameListView> view;
@@ -366,20 +379,11 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 
 	if (selectedViewType == AUTOMATIC)
 	{
-		std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME | FOLDER);
-		for (auto it = files.cbegin(); it != files.cend(); it++)
-		{
-			if (themeHasVideoView && !(*it)->getVideoPath().empty())
-			{
-				selectedViewType = VIDEO;
-				break;
-			}
-			else if (!(*it)->getThumbnailPath().empty())
-			{
-				selectedViewType = DETAILED;
-				// Don't break out in case any subsequent files have video
-			}
-		}
+		const unsigned int media = system->getMediaFlags();
+		if (themeHasVideoView && (media & MEDIA_VIDEO))
+			selectedViewType = VIDEO;
+		else if (media & MEDIA_THUMBNAIL)
+			selectedViewType = DETAILED;
 	}
 
 	// Create the view
@@ -409,6 +413,23 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	addChild(view.get());
 
 	mGameListViews[system] = view;
+
+	// the view was dropped from the cache before, put the cursor back where it was
+	auto evicted = mEvictedCursors.find(system);
+	if(evicted != mEvictedCursors.end())
+	{
+		// the game may have been removed while there was no view to tell
+		const std::vector<FileData*> files = system->getRootFolder()->getFilesRecursive(GAME | FOLDER);
+		if(std::find(files.cbegin(), files.cend(), evicted->second) != files.cend())
+		{
+			view->setCursor(evicted->second);
+			view->setViewportTop(mEvictedViewportTops[system]);
+		}
+
+		mEvictedCursors.erase(evicted);
+		mEvictedViewportTops.erase(system);
+	}
+
 	return view;
 }
 
@@ -449,6 +470,19 @@ bool ViewController::input(InputConfig* config, Input input)
 	return false;
 }
 
+bool ViewController::isAnimating() const
+{
+	// camera moves, fades and launch animations
+	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
+	{
+		if(isAnimationPlaying(i))
+			return true;
+	}
+
+	// every view is a child, but only the current one is updated
+	return mCurrentView && mCurrentView->isAnimating();
+}
+
 void ViewController::update(int deltaTime)
 {
 	if(mCurrentView)
@@ -457,6 +491,79 @@ void ViewController::update(int deltaTime)
 	}
 
 	updateSelf(deltaTime);
+
+	prepareGameListViews();
+}
+
+SystemData* ViewController::getFocusedSystem()
+{
+	if(mState.viewing == GAME_LIST)
+		return mState.getSystem();
+
+	if(mState.viewing == SYSTEM_SELECT && mSystemListView && mSystemListView->size() > 0)
+		return mSystemListView->getSelected();
+
+	return nullptr;
+}
+
+void ViewController::prepareGameListViews()
+{
+	// never compete with a transition or with the carousel while it scrolls
+	if(mLockInput || isAnimationPlaying(0) || (mState.viewing == SYSTEM_SELECT && mSystemListView && mSystemListView->isScrolling()))
+		return;
+
+	SystemData* focused = getFocusedSystem();
+	std::vector<SystemData*>& sysVec = SystemData::sSystemVector;
+	const int focusedId = getSystemId(focused);
+	if(focused == nullptr || focusedId >= (int)sysVec.size())
+		return;
+
+	// the focused system first, then the ones a single press away
+	SystemData* next = focused->getNext();
+	SystemData* prev = focused->getPrev();
+	SystemData* wanted[] = { focused, next, prev };
+	for(auto it = std::begin(wanted); it != std::end(wanted); ++it)
+	{
+		if(mGameListViews.find(*it) == mGameListViews.cend())
+		{
+			getGameListView(*it);
+			return;
+		}
+	}
+
+	const size_t maxVRAM = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024;
+	if(mGameListViews.size() <= GAMELIST_VIEW_CACHE_SIZE + 3 && TextureResource::getTotalMemUsage() <= maxVRAM)
+		return;
+
+	// drop the view the farthest away in carousel order
+	auto farthest = mGameListViews.end();
+	int farthestDistance = 0;
+	for(auto it = mGameListViews.begin(); it != mGameListViews.end(); ++it)
+	{
+		if(it->first == focused || it->first == next || it->first == prev || it->second == mCurrentView)
+			continue;
+
+		int distance = abs(getSystemId(it->first) - focusedId);
+		distance = Math::min(distance, (int)sysVec.size() - distance);
+		if(farthest == mGameListViews.end() || distance > farthestDistance)
+		{
+			farthest = it;
+			farthestDistance = distance;
+		}
+	}
+
+	if(farthest != mGameListViews.end())
+	{
+		// coming back to the system lands where it was left
+		FileData* cursor = farthest->second->getCursor();
+		if(cursor != nullptr && !cursor->isPlaceHolder())
+		{
+			mEvictedCursors[farthest->first] = cursor;
+			mEvictedViewportTops[farthest->first] = farthest->second->getViewportTop();
+		}
+
+		mGameListViews.erase(farthest);
+	}
 }
 
 void ViewController::render(const Transform4x4f& parentTrans)
@@ -501,24 +608,13 @@ void ViewController::render(const Transform4x4f& parentTrans)
 
 void ViewController::preload()
 {
-	int i = 1;
-	int max = SystemData::sSystemVector.size() + 1;
-
-	bool splash = Settings::getInstance()->getBool("SplashScreen");
-	if (splash)
-		mWindow->renderLoadingScreen("Preloading UI", (float)i / (float)max);
+	TraceScope("ViewController::preload");
+	if (Settings::getInstance()->getBool("SplashScreen"))
+		mWindow->renderLoadingScreen("Preloading UI");
 
+	// gamelist views are built when navigation gets close to them, see prepareGameListViews()
 	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
-	{
-		if (splash)
-		{
-			i++;
-			mWindow->renderLoadingScreen("Preloading UI", (float)i / (float)max);
-		}
-
 		(*it)->getIndex()->resetFilters();
-		getGameListView(*it);
-	}
 }
 
 void ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
@@ -533,6 +629,9 @@ void ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
 			int viewportTop = view->getViewportTop();
 			mGameListViews.erase(it);
 
+			// the view type and what it shows follow the media the games have now
+			system->invalidateMediaFlags();
+
 			if(reloadTheme)
 				system->loadTheme();
 			system->getIndex()->setUIModeFilters();
@@ -567,7 +666,17 @@ void ViewController::reloadAll(bool themeChanged)
 	}
 	mGameListViews.clear();
 
-	// load themes, create gamelistviews and reset filters
+	// load themes and reset filters, the carousel needs every system even if its gamelist view wasn't built yet
+	for(auto it = SystemData::sSystemVector.cbegin(); it != SystemData::sSystemVector.cend(); it++)
+	{
+		if(cursorMap.find(*it) == cursorMap.cend())
+		{
+			(*it)->loadTheme();
+			(*it)->getIndex()->resetFilters();
+		}
+	}
+
+	// recreate the gamelistviews that existed
 	for(auto it = cursorMap.cbegin(); it != cursorMap.cend(); it++)
 	{
 		it->first->loadTheme();
@@ -20,8 +20,8 @@ public:
 
 	virtual ~ViewController();
 
-	// Try to completely populate the GameListView map.
-	// Caches things so there's no pauses during transitions.
+	// Prepares the systems for display. Gamelist views are built on demand and ahead of
+	// navigation for the neighbours of the focused system, see prepareGameListViews().
 	void preload();
 
 	// If a basic view detected a metadata change, it can request to recreate
@@ -47,6 +47,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() const override;
 
 	enum ViewMode
 	{
@@ -94,8 +95,17 @@ private:
 	void playViewTransition();
 	int getSystemId(SystemData* system);
 
+	// System the user is looking at or about to open, nullptr if there is none.
+	SystemData* getFocusedSystem();
+	// Builds one missing view for the focused system or its neighbours per call, and drops
+	// the view farthest from it when too many are kept or textures are over the VRAM budget.
+	void prepareGameListViews();
+
 	std::shared_ptr<GuiComponent> mCurrentView;
 	std::map< SystemData*, std::shared_ptr<IGameListView> > mGameListViews;
+	// where the cursor was in views prepareGameListViews dropped, restored when they are built again
+	std::map<SystemData*, FileData*> mEvictedCursors;
+	std::map<SystemData*, int> mEvictedViewportTops;
 	std::shared_ptr<SystemView> mSystemListView;
 
 	Transform4x4f mCamera;
@@ -1,21 +1,27 @@
 #include "views/gamelist/BasicGameListView.h"
 
+#include "resources/TexturePrefetcher.h"
 #include "utils/FileSystemUtil.h"
 #include "views/UIModeController.h"
 #include "views/ViewController.h"
 #include "CollectionSystemManager.h"
 #include "Settings.h"
 #include "SystemData.h"
+#include <algorithm>
+
+// games whose media is decoded ahead of the cursor, and behind it in case it turns around
+#define PREFETCH_AHEAD 6
+#define PREFETCH_BEHIND 2
 
 BasicGameListView::BasicGameListView(Window* window, FileData* root)
-	: ISimpleGameListView(window, root), mList(window)
+	: ISimpleGameListView(window, root), mList(window), mPrefetchCursor(-1)
 {
 	mList.setSize(mSize.x(), mSize.y() * 0.8f);
 	mList.setPosition(0, mSize.y() * 0.2f);
 	mList.setDefaultZIndex(20);
 	addChild(&mList);
 
-	populateList(root->getChildrenListToDisplay());
+	populateFolder(root);
 }
 
 void BasicGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
@@ -39,6 +45,70 @@ void BasicGameListView::onFileChanged(FileData* file, FileChangeType change)
 	ISimpleGameListView::onFileChanged(file, change);
 }
 
+void BasicGameListView::prefetchMedia(const ImageComponent& thumbnail, const ImageComponent& marquee, const ImageComponent& image)
+{
+	// nothing is shown while the list flies by, what was wanted before is still on its way
+	if(mList.size() == 0 || mList.isScrolling())
+		return;
+
+	const int size = mList.size();
+	const int cursor = mList.getCursorIndex();
+
+	// a single step tells where the cursor goes next, anything else was a jump
+	int direction = 0;
+	if(mPrefetchCursor >= 0 && mPrefetchCursor < size)
+	{
+		if(cursor == (mPrefetchCursor + 1) % size)
+			direction = 1;
+		else if(cursor == (mPrefetchCursor - 1 + size) % size)
+			direction = -1;
+	}
+	mPrefetchCursor = cursor;
+
+	std::vector<int> offsets;
+	if(direction != 0)
+	{
+		for(int i = 1; i <= PREFETCH_AHEAD; i++)
+			offsets.push_back(i * direction);
+		for(int i = 1; i <= PREFETCH_BEHIND; i++)
+			offsets.push_back(-i * direction);
+	}
+	else
+	{
+		for(int i = 1; i <= (PREFETCH_AHEAD + PREFETCH_BEHIND) / 2; i++)
+		{
+			offsets.push_back(i);
+			offsets.push_back(-i);
+		}
+	}
+
+	const unsigned int media = mRoot->getSystem()->getMediaFlags();
+	std::vector<TexturePrefetcher::Request> requests;
+	std::vector<int> visited(1, cursor);
+
+	for(auto it = offsets.cbegin(); it != offsets.cend(); it++)
+	{
+		// the list wraps around
+		const int index = ((cursor + *it) % size + size) % size;
+		if(std::find(visited.cbegin(), visited.cend(), index) != visited.cend())
+			continue;
+		visited.push_back(index);
+
+		FileData* file = mList.getObjectAt(index);
+		if(file->isPlaceHolder())
+			continue;
+
+		if(media & MEDIA_IMAGE)
+			requests.push_back(image.getPrefetchRequest(file->getImagePath()));
+		if(media & MEDIA_THUMBNAIL)
+			requests.push_back(thumbnail.getPrefetchRequest(file->getThumbnailPath()));
+		if(media & MEDIA_MARQUEE)
+			requests.push_back(marquee.getPrefetchRequest(file->getMarqueePath()));
+	}
+
+	TexturePrefetcher::getInstance().prefetch(requests);
+}
+
 void BasicGameListView::populateList(const std::vector<FileData*>& files)
 {
 	mList.clear();
@@ -69,7 +139,7 @@ void BasicGameListView::setCursor(FileData* cursor, bool refreshListCursorPos)
 	bool notInList = !mList.setCursor(cursor);
 	if(!refreshListCursorPos && notInList && !cursor->isPlaceHolder())
 	{
-		populateList(cursor->getParent()->getChildrenListToDisplay());
+		populateFolder(cursor->getParent());
 		// this extra call is needed iff a system has games organized in folders
 		// and the cursor is focusing a game in a folder
 		if (cursor->getParent()->getType() == FOLDER)
@@ -34,7 +34,13 @@ protected:
 	virtual void remove(FileData* game, bool deleteFile, bool refreshView=true) override;
 	virtual void addPlaceholder();
 
+	// decodes the media of the games around the cursor in the background, mostly in the direction it moves
+	void prefetchMedia(const ImageComponent& thumbnail, const ImageComponent& marquee, const ImageComponent& image);
+
 	TextListComponent<FileData*> mList;
+
+private:
+	int mPrefetchCursor;
 };
 
 #endif // ES_APP_VIEWS_GAME_LIST_BASIC_GAME_LIST_VIEW_H
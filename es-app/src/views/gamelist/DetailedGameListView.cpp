@@ -2,6 +2,7 @@
 
 #include "animations/LambdaAnimation.h"
 #include "views/ViewController.h"
+#include "SystemData.h"
 
 DetailedGameListView::DetailedGameListView(Window* window, FileData* root) :
 	BasicGameListView(window, root),
@@ -221,9 +222,11 @@ void DetailedGameListView::updateInfoPanel()
 		//mDescription.setText("");
 		fadingOut = true;
 	}else{
-		mThumbnail.setImage(file->getThumbnailPath());
-		mMarquee.setImage(file->getMarqueePath());
-		mImage.setImage(file->getImagePath());
+		const unsigned int media = mRoot->getSystem()->getMediaFlags();
+		mThumbnail.setImage((media & MEDIA_THUMBNAIL) ? file->getThumbnailPath() : "");
+		mMarquee.setImage((media & MEDIA_MARQUEE) ? file->getMarqueePath() : "");
+		mImage.setImage((media & MEDIA_IMAGE) ? file->getImagePath() : "");
+		prefetchMedia(mThumbnail, mMarquee, mImage);
 		mDescription.setText(file->metadata.get("desc"));
 		mDescContainer.reset();
 
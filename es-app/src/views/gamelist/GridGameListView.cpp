@@ -43,7 +43,7 @@ GridGameListView::GridGameListView(Window* window, FileData* root) :
 	mGrid.setCursorChangedCallback([&](const CursorState& /*state*/) { updateInfoPanel(); });
 	addChild(&mGrid);
 
-	populateList(root->getChildrenListToDisplay());
+	populateFolder(root);
 
 	// metadata labels + values
 	mLblRating.setText("Rating: ");
@@ -135,7 +135,7 @@ void GridGameListView::setCursor(FileData* file, bool refreshListCursorPos)
 {
 	if(!mGrid.setCursor(file) && (!file->isPlaceHolder()))
 	{
-		populateList(file->getParent()->getChildrenListToDisplay());
+		populateFolder(file->getParent());
 		mGrid.setCursor(file);
 	}
 }
@@ -232,7 +232,7 @@ void GridGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
 
 	// Repopulate list in case new theme is displaying a different image.  Preserve selection.
 	FileData* file = mGrid.getSelected();
-	populateList(mRoot->getChildrenListToDisplay());
+	populateFolder(mRoot, true);
 	mGrid.setCursor(file);
 
 	sortChildren();
@@ -317,15 +317,16 @@ void GridGameListView::updateInfoPanel()
 		//mDescription.setText("");
 		fadingOut = true;
 	}else{
-		if (!mVideo->setVideo(file->getVideoPath()))
+		const unsigned int media = mRoot->getSystem()->getMediaFlags();
+		if (!mVideo->setVideo((media & MEDIA_VIDEO) ? file->getVideoPath() : ""))
 		{
 			mVideo->setDefaultVideo();
 		}
 		mVideoPlaying = true;
 
-		mVideo->setImage(file->getThumbnailPath());
-		mMarquee.setImage(file->getMarqueePath());
-		mImage.setImage(file->getImagePath());
+		mVideo->setImage((media & MEDIA_THUMBNAIL) ? file->getThumbnailPath() : "");
+		mMarquee.setImage((media & MEDIA_MARQUEE) ? file->getMarqueePath() : "");
+		mImage.setImage((media & MEDIA_IMAGE) ? file->getImagePath() : "");
 
 		mDescription.setText(file->metadata.get("desc"));
 		mDescContainer.reset();
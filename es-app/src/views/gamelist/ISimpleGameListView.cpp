@@ -9,7 +9,7 @@
 #include "SystemData.h"
 
 ISimpleGameListView::ISimpleGameListView(Window* window, FileData* root) : IGameListView(window, root),
-	mHeaderText(window), mHeaderImage(window), mBackground(window)
+	mHeaderText(window), mHeaderImage(window), mBackground(window), mPopulatedFolder(nullptr), mPopulatedGeneration(0)
 {
 	mHeaderText.setText("Logo Text");
 	mHeaderText.setSize(mSize.x(), 0);
@@ -61,22 +61,32 @@ void ISimpleGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme
 	}
 }
 
-void ISimpleGameListView::onFileChanged(FileData* /*file*/, FileChangeType /*change*/)
+void ISimpleGameListView::onFileChanged(FileData* /*file*/, FileChangeType change)
 {
-	// we could be tricky here to be efficient;
-	// but this shouldn't happen very often so we'll just always repopulate
+	// sorts and filter changes that didn't change the list are skipped, new metadata may change the names shown
 	FileData* cursor = getCursor();
 	if (!cursor->isPlaceHolder()) {
-		populateList(cursor->getParent()->getChildrenListToDisplay());
+		populateFolder(cursor->getParent(), change == FILE_METADATA_CHANGED);
 		setCursor(cursor);
 	}
 	else
 	{
-		populateList(mRoot->getChildrenListToDisplay());
+		populateFolder(mRoot, change == FILE_METADATA_CHANGED);
 		setCursor(cursor);
 	}
 }
 
+void ISimpleGameListView::populateFolder(FileData* folder, bool force)
+{
+	const unsigned int generation = folder->getDisplayGeneration();
+	if(!force && folder == mPopulatedFolder && generation == mPopulatedGeneration)
+		return;
+
+	populateList(folder->getChildrenListToDisplay());
+	mPopulatedFolder = folder;
+	mPopulatedGeneration = generation;
+}
+
 bool ISimpleGameListView::input(InputConfig* config, Input input)
 {
 	if(input.value != 0)
@@ -93,7 +103,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 				if(cursor->getChildren().size() > 0)
 				{
 					mCursorStack.push(cursor);
-					populateList(cursor->getChildrenListToDisplay());
+					populateFolder(cursor);
 					FileData* cursor = getCursor();
 					setCursor(cursor);
 				}
@@ -104,7 +114,7 @@ bool ISimpleGameListView::input(InputConfig* config, Input input)
 		{
 			if(mCursorStack.size())
 			{
-				populateList(mCursorStack.top()->getParent()->getChildrenListToDisplay());
+				populateFolder(mCursorStack.top()->getParent());
 				setCursor(mCursorStack.top());
 				mCursorStack.pop();
 				Sound::getFromTheme(getTheme(), getName(), "back")->play();
@@ -37,6 +37,9 @@ protected:
 	virtual std::string getQuickSystemSelectLeftButton() = 0;
 	virtual void populateList(const std::vector<FileData*>& files) = 0;
 
+	// populates the list with the children of folder, unless it shows them already and they didn't change since
+	void populateFolder(FileData* folder, bool force = false);
+
 	TextComponent mHeaderText;
 	ImageComponent mHeaderImage;
 	ImageComponent mBackground;
@@ -44,6 +47,10 @@ protected:
 	std::vector<GuiComponent*> mThemeExtras;
 
 	std::stack<FileData*> mCursorStack;
+
+private:
+	FileData* mPopulatedFolder;
+	unsigned int mPopulatedGeneration;
 };
 
 #endif // ES_APP_VIEWS_GAME_LIST_ISIMPLE_GAME_LIST_VIEW_H
@@ -10,6 +10,7 @@
 #ifdef _OMX_
 #include "Settings.h"
 #endif
+#include "SystemData.h"
 
 VideoGameListView::VideoGameListView(Window* window, FileData* root) :
 	BasicGameListView(window, root),
@@ -259,16 +260,19 @@ void VideoGameListView::updateInfoPanel()
 		fadingOut = true;
 
 	}else{
-		if (!mVideo->setVideo(file->getVideoPath()))
+		const unsigned int media = mRoot->getSystem()->getMediaFlags();
+		if (!mVideo->setVideo((media & MEDIA_VIDEO) ? file->getVideoPath() : ""))
 		{
 			mVideo->setDefaultVideo();
 		}
 		mVideoPlaying = true;
 
-		mVideo->setImage(file->getThumbnailPath());
-		mThumbnail.setImage(file->getThumbnailPath());
-		mMarquee.setImage(file->getMarqueePath());
-		mImage.setImage(file->getImagePath());
+		const std::string thumbnail = (media & MEDIA_THUMBNAIL) ? file->getThumbnailPath() : "";
+		mVideo->setImage(thumbnail);
+		mThumbnail.setImage(thumbnail);
+		mMarquee.setImage((media & MEDIA_MARQUEE) ? file->getMarqueePath() : "");
+		mImage.setImage((media & MEDIA_IMAGE) ? file->getImagePath() : "");
+		prefetchMedia(mThumbnail, mMarquee, mImage);
 
 		mDescription.setText(file->metadata.get("desc"));
 		mDescContainer.reset();
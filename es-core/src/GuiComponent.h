@@ -137,6 +137,10 @@ public:
 	// Returns true if the component is busy doing background processing (e.g. HTTP downloads)
 	bool isProcessing() const;
 
+	// Returns true if the component will look different on the next frame even without input,
+	// e.g. while an animation, a video or a marquee is running. Default checks animations and children.
+	virtual bool isAnimating() const;
+
 protected:
 	void renderChildren(const Transform4x4f& transform) const;
 	void updateSelf(int deltaTime); // updates animations
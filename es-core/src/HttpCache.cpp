@@ -0,0 +1,405 @@
+#include "HttpCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "Log.h"
+#include "Settings.h"
+#include <algorithm>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+// freshness of responses that don't say, scraper services rarely send caching headers
+#define HTTPCACHE_DEFAULT_MAX_AGE (7 * 24 * 60 * 60)
+// stores between two writes of the index
+#define HTTPCACHE_SAVE_INTERVAL 50
+
+// query parameters carrying credentials, left out of the cache key
+static const char* sCredentialParams[] = { "apikey", "devid", "devpassword", "ssid", "sspassword", "password", "token" };
+
+HttpCache& HttpCache::getInstance()
+{
+	static HttpCache instance;
+	return instance;
+}
+
+HttpCache::HttpCache() : mSize(0), mDirty(false), mUnsavedStores(0)
+{
+	mStats.hits = 0;
+	mStats.misses = 0;
+
+	mPath = Utils::FileSystem::getGenericPath(Utils::FileSystem::getHomePath() + "/.emulationstation/cache/http");
+	mMaxSize = (long long)Settings::getInstance()->getInt("ScraperCacheSize") * 1024 * 1024;
+
+	if(mMaxSize > 0)
+		load();
+}
+
+HttpCache::~HttpCache()
+{
+	save();
+}
+
+bool HttpCache::isEnabled()
+{
+	return mMaxSize > 0;
+}
+
+std::string HttpCache::normalizeUrl(const std::string& url)
+{
+	std::string scheme;
+	std::string rest = url;
+
+	const size_t schemeEnd = url.find("://");
+	if(schemeEnd != std::string::npos)
+	{
+		scheme = Utils::String::toLower(url.substr(0, schemeEnd)) + "://";
+		rest = url.substr(schemeEnd + 3);
+	}
+
+	// the fragment never reaches the server
+	const size_t fragment = rest.find('#');
+	if(fragment != std::string::npos)
+		rest.erase(fragment);
+
+	std::string query;
+	const size_t queryStart = rest.find('?');
+	if(queryStart != std::string::npos)
+	{
+		query = rest.substr(queryStart + 1);
+		rest.erase(queryStart);
+	}
+
+	// host, without user:password@
+	const size_t pathStart = rest.find('/');
+	std::string host = rest.substr(0, pathStart);
+	const size_t at = host.rfind('@');
+	if(at != std::string::npos)
+		host.erase(0, at + 1);
+
+	std::string normalized = scheme + Utils::String::toLower(host) + (pathStart != std::string::npos ? rest.substr(pathStart) : "/");
+
+	// keep the parameters that select the response, in a fixed order
+	std::vector<std::string> params;
+	size_t start = 0;
+	while(start < query.size())
+	{
+		size_t end = query.find('&', start);
+		if(end == std::string::npos)
+			end = query.size();
+
+		const std::string param = query.substr(start, end - start);
+		const std::string name = Utils::String::toLower(param.substr(0, param.find('=')));
+		bool credential = false;
+		for(size_t i = 0; i < sizeof(sCredentialParams) / sizeof(sCredentialParams[0]); i++)
+		{
+			if(name == sCredentialParams[i])
+			{
+				credential = true;
+				break;
+			}
+		}
+
+		if(!param.empty() && !credential)
+			params.push_back(param);
+
+		start = end + 1;
+	}
+
+	std::sort(params.begin(), params.end());
+	for(size_t i = 0; i < params.size(); i++)
+		normalized += (i == 0 ? "?" : "&") + params[i];
+
+	return normalized;
+}
+
+std::string HttpCache::getKey(const std::string& url)
+{
+	// FNV-1a
+	const std::string normalized = normalizeUrl(url);
+	unsigned long long hash = 14695981039346656037ULL;
+	for(size_t i = 0; i < normalized.size(); i++)
+	{
+		hash ^= (unsigned char)normalized[i];
+		hash *= 1099511628211ULL;
+	}
+
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", hash);
+	return key;
+}
+
+long long HttpCache::getExpiry(const std::string& cacheControl, bool& store_out)
+{
+	const std::string directives = Utils::String::toLower(cacheControl);
+	const long long now = (long long)time(NULL);
+
+	store_out = directives.find("no-store") == std::string::npos;
+
+	// may be stored, but has to be revalidated every time
+	if(directives.find("no-cache") != std::string::npos)
+		return 0;
+
+	const size_t maxAge = directives.find("max-age=");
+	if(maxAge != std::string::npos)
+		return now + atoll(directives.c_str() + maxAge + 8);
+
+	return now + HTTPCACHE_DEFAULT_MAX_AGE;
+}
+
+bool HttpCache::lookup(const std::string& url, Lookup& lookup_out)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	if(!isEnabled())
+		return false;
+
+	auto it = mIndex.find(getKey(url));
+	if(it == mIndex.end())
+	{
+		mStats.misses++;
+		return false;
+	}
+
+	// most recently used
+	mEntries.splice(mEntries.begin(), mEntries, it->second);
+	mDirty = true;
+
+	const Entry& entry = *it->second;
+	if(!Utils::FileSystem::exists(mPath + "/" + entry.key))
+	{
+		remove(it->second);
+		mStats.misses++;
+		return false;
+	}
+
+	lookup_out.path = mPath + "/" + entry.key;
+	lookup_out.etag = entry.etag;
+	lookup_out.lastModified = entry.lastModified;
+	lookup_out.fresh = entry.expires > (long long)time(NULL);
+
+	// stale responses count once the server answered
+	if(lookup_out.fresh)
+		mStats.hits++;
+
+	return true;
+}
+
+HttpCache::Entry* HttpCache::beginStore(const std::string& url, const std::string& etag, const std::string& lastModified, const std::string& cacheControl, bool& store_out)
+{
+	const std::string key = getKey(url);
+	const long long expires = getExpiry(cacheControl, store_out);
+
+	auto it = mIndex.find(key);
+	if(it != mIndex.end())
+	{
+		// a stale response that had to be downloaded again
+		mStats.misses++;
+
+		if(!store_out)
+		{
+			remove(it->second);
+			return nullptr;
+		}
+
+		mEntries.splice(mEntries.begin(), mEntries, it->second);
+	}
+	else
+	{
+		if(!store_out)
+			return nullptr;
+
+		Entry entry;
+		entry.key = key;
+		entry.size = 0;
+		mEntries.push_front(entry);
+		mIndex[key] = mEntries.begin();
+	}
+
+	Entry& entry = mEntries.front();
+	entry.etag = etag;
+	entry.lastModified = lastModified;
+	entry.expires = expires;
+	mSize -= entry.size;
+	entry.size = 0;
+
+	return &entry;
+}
+
+void HttpCache::endStore(Entry* entry)
+{
+	entry->size = Utils::FileSystem::getFileSize(mPath + "/" + entry->key);
+	if(entry->size < 0)
+	{
+		remove(mIndex[entry->key]);
+		return;
+	}
+
+	mSize += entry->size;
+	mDirty = true;
+
+	evict();
+
+	if(++mUnsavedStores >= HTTPCACHE_SAVE_INTERVAL)
+		writeIndex();
+}
+
+void HttpCache::store(const std::string& url, const std::string& content, const std::string& etag, const std::string& lastModified, const std::string& cacheControl)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	if(!isEnabled())
+		return;
+
+	bool store = false;
+	Entry* entry = beginStore(url, etag, lastModified, cacheControl, store);
+	if(!entry)
+		return;
+
+	std::ofstream stream(mPath + "/" + entry->key, std::ios_base::out | std::ios_base::binary);
+	stream.write(content.data(), content.length());
+	stream.close();
+	if(stream.fail())
+	{
+		LOG(LogWarning) << "Could not write the HTTP cache entry for " << normalizeUrl(url);
+		remove(mIndex[entry->key]);
+		return;
+	}
+
+	endStore(entry);
+}
+
+void HttpCache::storeFile(const std::string& url, const std::string& path, const std::string& etag, const std::string& lastModified, const std::string& cacheControl)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	if(!isEnabled())
+		return;
+
+	bool store = false;
+	Entry* entry = beginStore(url, etag, lastModified, cacheControl, store);
+	if(!entry)
+		return;
+
+	std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+	std::ofstream out(mPath + "/" + entry->key, std::ios_base::out | std::ios_base::binary);
+	if(in.is_open() && in.peek() != EOF)
+		out << in.rdbuf();
+	out.close();
+	if(!in.is_open() || out.fail())
+	{
+		LOG(LogWarning) << "Could not write the HTTP cache entry for " << normalizeUrl(url);
+		remove(mIndex[entry->key]);
+		return;
+	}
+
+	endStore(entry);
+}
+
+void HttpCache::notModified(const std::string& url, const std::string& cacheControl)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mIndex.find(getKey(url));
+	if(it == mIndex.end())
+		return;
+
+	bool store = false;
+	it->second->expires = getExpiry(cacheControl, store);
+	mStats.hits++;
+	mDirty = true;
+}
+
+HttpCache::Stats HttpCache::getStats()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+void HttpCache::evict()
+{
+	// keep the most recent entry even when it is larger than the whole cache
+	while(mSize > mMaxSize && mEntries.size() > 1)
+		remove(std::prev(mEntries.end()));
+}
+
+void HttpCache::remove(std::list<Entry>::iterator it)
+{
+	Utils::FileSystem::removeFile(mPath + "/" + it->key);
+	mSize -= it->size;
+	mIndex.erase(it->key);
+	mEntries.erase(it);
+	mDirty = true;
+}
+
+// the index holds one entry per line, most recently used first:
+// key, expires, size, etag, last modified separated by tabs
+void HttpCache::load()
+{
+	if(!Utils::FileSystem::exists(mPath))
+	{
+		Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(mPath));
+		Utils::FileSystem::createDirectory(mPath);
+		return;
+	}
+
+	std::ifstream stream(mPath + "/index");
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		std::vector<std::string> fields;
+		size_t start = 0;
+		for(size_t tab = line.find('\t'); tab != std::string::npos; tab = line.find('\t', start))
+		{
+			fields.push_back(line.substr(start, tab - start));
+			start = tab + 1;
+		}
+		fields.push_back(line.substr(start));
+
+		if(fields.size() != 5 || mIndex.find(fields[0]) != mIndex.end())
+			continue;
+
+		Entry entry;
+		entry.key = fields[0];
+		entry.expires = atoll(fields[1].c_str());
+		entry.size = atoll(fields[2].c_str());
+		entry.etag = fields[3];
+		entry.lastModified = fields[4];
+
+		mEntries.push_back(entry);
+		mIndex[entry.key] = std::prev(mEntries.end());
+		mSize += entry.size;
+	}
+
+	// bodies the index doesn't know about were written after the last time it was saved
+	const Utils::FileSystem::stringList files = Utils::FileSystem::getDirContent(mPath);
+	for(auto it = files.cbegin(); it != files.cend(); it++)
+	{
+		const std::string name = Utils::FileSystem::getFileName(*it);
+		if(name != "index" && mIndex.find(name) == mIndex.end())
+			Utils::FileSystem::removeFile(*it);
+	}
+
+	evict();
+}
+
+void HttpCache::save()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	writeIndex();
+}
+
+void HttpCache::writeIndex()
+{
+	if(!mDirty)
+		return;
+
+	std::ofstream stream(mPath + "/index", std::ios_base::out | std::ios_base::trunc);
+	for(auto it = mEntries.cbegin(); it != mEntries.cend(); it++)
+		stream << it->key << '\t' << it->expires << '\t' << it->size << '\t' << it->etag << '\t' << it->lastModified << '\n';
+
+	mDirty = false;
+	mUnsavedStores = 0;
+}
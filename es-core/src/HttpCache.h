@@ -0,0 +1,89 @@
+#pragma once
+#ifndef ES_CORE_HTTP_CACHE_H
+#define ES_CORE_HTTP_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// On-disk cache of HTTP responses in ~/.emulationstation/cache/http, used by HttpReq when a
+// request asks for it. Responses are stored under a hash of their normalized URL, without the
+// credentials it carries, and are revalidated with their ETag or Last-Modified once their
+// max-age ran out. The least recently used responses go once the cache is over the size set
+// by "ScraperCacheSize" (in MB, 0 disables the cache).
+class HttpCache
+{
+public:
+	struct Stats
+	{
+		unsigned int hits;   // answered from the cache, including revalidated responses
+		unsigned int misses; // downloaded
+	};
+
+	// a cached response for a request
+	struct Lookup
+	{
+		std::string path;         // body
+		std::string etag;
+		std::string lastModified;
+		bool        fresh;        // can be used without asking the server
+	};
+
+	static HttpCache& getInstance();
+
+	bool isEnabled();
+
+	// returns false when there is nothing cached for url
+	bool lookup(const std::string& url, Lookup& lookup_out);
+
+	// stores a 200 response, from memory or from the file it was written to
+	void store(const std::string& url, const std::string& content, const std::string& etag, const std::string& lastModified, const std::string& cacheControl);
+	void storeFile(const std::string& url, const std::string& path, const std::string& etag, const std::string& lastModified, const std::string& cacheControl);
+
+	// the server answered 304, the cached response is fresh again
+	void notModified(const std::string& url, const std::string& cacheControl);
+
+	Stats getStats();
+
+	// writes the index of the cache if it changed
+	void save();
+
+	static std::string normalizeUrl(const std::string& url);
+
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string etag;
+		std::string lastModified;
+		long long   expires; // seconds since epoch
+		long long   size;
+	};
+
+	HttpCache();
+	~HttpCache();
+
+	void load();
+	void writeIndex();
+	Entry* beginStore(const std::string& url, const std::string& etag, const std::string& lastModified, const std::string& cacheControl, bool& store_out);
+	void endStore(Entry* entry);
+	void evict();
+	void remove(std::list<Entry>::iterator it);
+
+	static std::string getKey(const std::string& url);
+	static long long getExpiry(const std::string& cacheControl, bool& store_out);
+
+	std::mutex  mMutex;
+	std::string mPath;
+	long long   mMaxSize;
+	long long   mSize;
+	bool        mDirty;
+	unsigned int mUnsavedStores;
+	Stats       mStats;
+
+	std::list<Entry> mEntries; // most recently used first
+	std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+};
+
+#endif // ES_CORE_HTTP_CACHE_H
@@ -1,12 +1,257 @@
 #include "HttpReq.h"
 
 #include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "utils/TracingUtil.h"
+#include "HttpCache.h"
 #include "Log.h"
 #include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// how long the network thread waits on its sockets before checking for new or cancelled requests,
+// only matters when curl can't be woken up (before 7.68.0)
+#define HTTPREQ_POLL_TIMEOUT_MS 100
+
+// one transfer, owned by its HttpReq and by the network thread while the thread uses the handle
+class HttpTransfer
+{
+public:
+	HttpTransfer() : handle(nullptr), headers(nullptr), status(HttpReq::REQ_IN_PROGRESS), responseCode(0), cancelled(false) {}
+
+	CURL* handle; // only touched by the network thread once submitted
+	struct curl_slist* headers;
+
+	// set by the network thread when the transfer ends, what's below is complete from then on
+	std::atomic<HttpReq::Status> status;
+	std::string error;
+	std::string content;
+	long responseCode;
+
+	// response headers the cache needs, only collected for cached requests
+	std::string etag;
+	std::string lastModified;
+	std::string cacheControl;
+
+	std::string savePath;
+	std::ofstream file;
+
+	std::atomic<bool> cancelled;
+};
+
+// Runs every transfer on a single curl multi handle, so connections are reused and HTTP/2
+// requests to the same host share one connection.
+class HttpThread
+{
+public:
+	static HttpThread& getInstance()
+	{
+		static HttpThread instance;
+		return instance;
+	}
+
+	~HttpThread()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mRunning = false;
+		}
+		wakeUp();
+		mThread.join();
+
+		curl_multi_cleanup(mMulti);
+	}
+
+	void submit(const std::shared_ptr<HttpTransfer>& transfer)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mAdded.push_back(transfer);
+		}
+		wakeUp();
+	}
+
+	void cancel(const std::shared_ptr<HttpTransfer>& transfer)
+	{
+		transfer->cancelled = true;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCancelled.push_back(transfer);
+		}
+		wakeUp();
+	}
+
+private:
+	HttpThread() : mMulti(curl_multi_init()), mRunning(true)
+	{
+		curl_multi_setopt(mMulti, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+		mThread = std::thread(&HttpThread::run, this);
+	}
+
+	void wakeUp()
+	{
+		mCondition.notify_one();
+#if CURL_AT_LEAST_VERSION(7,68,0)
+		curl_multi_wakeup(mMulti);
+#endif
+	}
+
+	void run()
+	{
+		Utils::Tracing::setThreadName("network");
+
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+
+				// nothing to transfer, sleep until there is
+				while(mRunning && mTransfers.empty() && mAdded.empty() && mCancelled.empty())
+					mCondition.wait(lock);
+
+				if(!mRunning)
+					break;
+
+				for(auto it = mAdded.cbegin(); it != mAdded.cend(); it++)
+				{
+					const std::shared_ptr<HttpTransfer>& transfer = *it;
+					if(transfer->cancelled)
+					{
+						finish(transfer, HttpReq::REQ_IO_ERROR, "cancelled");
+						continue;
+					}
+
+					CURLMcode merr = curl_multi_add_handle(mMulti, transfer->handle);
+					if(merr != CURLM_OK)
+					{
+						finish(transfer, HttpReq::REQ_IO_ERROR, curl_multi_strerror(merr));
+						continue;
+					}
+
+					mTransfers[transfer->handle] = transfer;
+				}
+				mAdded.clear();
+
+				for(auto it = mCancelled.cbegin(); it != mCancelled.cend(); it++)
+				{
+					const std::shared_ptr<HttpTransfer>& transfer = *it;
+
+					// it may have ended already
+					if(!transfer->handle)
+						continue;
+
+					mTransfers.erase(transfer->handle);
+					curl_multi_remove_handle(mMulti, transfer->handle);
+					finish(transfer, HttpReq::REQ_IO_ERROR, "cancelled");
+				}
+				mCancelled.clear();
+			}
+
+			{
+				TraceScope("HttpThread::perform");
+
+				int handle_count;
+				CURLMcode merr = curl_multi_perform(mMulti, &handle_count);
+				if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
+				{
+					// the multi handle is broken, fail everything in flight
+					for(auto it = mTransfers.cbegin(); it != mTransfers.cend(); it++)
+					{
+						curl_multi_remove_handle(mMulti, it->first);
+						finish(it->second, HttpReq::REQ_IO_ERROR, curl_multi_strerror(merr));
+					}
+					mTransfers.clear();
+					continue;
+				}
+
+				int msgs_left;
+				CURLMsg* msg;
+				while((msg = curl_multi_info_read(mMulti, &msgs_left)) != nullptr)
+				{
+					if(msg->msg != CURLMSG_DONE)
+						continue;
+
+					auto it = mTransfers.find(msg->easy_handle);
+					if(it == mTransfers.end())
+					{
+						LOG(LogError) << "Cannot find easy handle!";
+						continue;
+					}
+
+					std::shared_ptr<HttpTransfer> transfer = it->second;
+					const CURLcode result = msg->data.result;
+					mTransfers.erase(it);
+					curl_multi_remove_handle(mMulti, transfer->handle);
+
+					if(result == CURLE_OK)
+						finish(transfer, HttpReq::REQ_SUCCESS, "");
+					else
+						finish(transfer, HttpReq::REQ_IO_ERROR, curl_easy_strerror(result));
+				}
+			}
 
-CURLM* HttpReq::s_multi_handle = curl_multi_init();
+			if(!mTransfers.empty())
+			{
+#if CURL_AT_LEAST_VERSION(7,68,0)
+				curl_multi_poll(mMulti, nullptr, 0, 1000, nullptr);
+#else
+				curl_multi_wait(mMulti, nullptr, 0, HTTPREQ_POLL_TIMEOUT_MS, nullptr);
+#endif
+			}
+		}
 
-std::map<CURL*, HttpReq*> HttpReq::s_requests;
+		for(auto it = mTransfers.cbegin(); it != mTransfers.cend(); it++)
+		{
+			curl_multi_remove_handle(mMulti, it->first);
+			finish(it->second, HttpReq::REQ_IO_ERROR, "shutting down");
+		}
+		mTransfers.clear();
+	}
+
+	// ends a transfer that is not in the multi handle anymore
+	static void finish(const std::shared_ptr<HttpTransfer>& transfer, HttpReq::Status status, const char* error)
+	{
+		curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &transfer->responseCode);
+		curl_easy_cleanup(transfer->handle);
+		transfer->handle = nullptr;
+		curl_slist_free_all(transfer->headers);
+		transfer->headers = nullptr;
+
+		if(transfer->file.is_open())
+		{
+			transfer->file.close();
+			if(status == HttpReq::REQ_SUCCESS && transfer->file.fail())
+			{
+				status = HttpReq::REQ_IO_ERROR;
+				error = "Failed to write the file, disk full?";
+			}
+
+			// don't leave a partial file behind
+			if(status != HttpReq::REQ_SUCCESS)
+				Utils::FileSystem::removeFile(transfer->savePath);
+		}
+
+		transfer->error = error;
+		transfer->status.store(status, std::memory_order_release);
+	}
+
+	CURLM* mMulti;
+	std::thread mThread;
+
+	std::mutex mMutex; // guards what's below, the multi handle and mTransfers belong to the thread
+	std::condition_variable mCondition;
+	bool mRunning;
+	std::vector< std::shared_ptr<HttpTransfer> > mAdded;
+	std::vector< std::shared_ptr<HttpTransfer> > mCancelled;
+
+	std::map< CURL*, std::shared_ptr<HttpTransfer> > mTransfers;
+};
 
 std::string HttpReq::urlEncode(const std::string &s)
 {
@@ -37,12 +282,35 @@ bool HttpReq::isUrl(const std::string& str)
 		(str.find("http://") != std::string::npos || str.find("https://") != std::string::npos || str.find("www.") != std::string::npos));
 }
 
-HttpReq::HttpReq(const std::string& url)
-	: mStatus(REQ_IN_PROGRESS), mHandle(NULL)
+HttpReq::HttpReq(const std::string& url, const std::string& saveAs, bool cached)
+	: mTransfer(std::make_shared<HttpTransfer>()), mStatus(REQ_IN_PROGRESS)
 {
-	mHandle = curl_easy_init();
+	mTransfer->savePath = saveAs;
 
-	if(mHandle == NULL)
+	HttpCache::Lookup cachedResponse;
+	cachedResponse.fresh = false;
+	if(cached && HttpCache::getInstance().isEnabled())
+	{
+		mCacheUrl = url;
+
+		if(HttpCache::getInstance().lookup(url, cachedResponse))
+		{
+			if(cachedResponse.fresh && loadCached(cachedResponse.path))
+			{
+				mStatus = REQ_SUCCESS;
+				mTransfer->status = REQ_SUCCESS;
+				return;
+			}
+
+			// stale, ask the server whether it changed
+			mCachePath = cachedResponse.path;
+		}
+	}
+
+	CURL*& handle = mTransfer->handle;
+	handle = curl_easy_init();
+
+	if(handle == NULL)
 	{
 		mStatus = REQ_IO_ERROR;
 		onError("curl_easy_init failed");
@@ -50,7 +318,7 @@ HttpReq::HttpReq(const std::string& url)
 	}
 
 	//set the url
-	CURLcode err = curl_easy_setopt(mHandle, CURLOPT_URL, url.c_str());
+	CURLcode err = curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
 	if(err != CURLE_OK)
 	{
 		mStatus = REQ_IO_ERROR;
@@ -59,7 +327,7 @@ HttpReq::HttpReq(const std::string& url)
 	}
 
 	//set curl to handle redirects
-	err = curl_easy_setopt(mHandle, CURLOPT_FOLLOWLOCATION, 1L);
+	err = curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
 	if(err != CURLE_OK)
 	{
 		mStatus = REQ_IO_ERROR;
@@ -68,7 +336,7 @@ HttpReq::HttpReq(const std::string& url)
 	}
 
 	//set curl max redirects
-	err = curl_easy_setopt(mHandle, CURLOPT_MAXREDIRS, 2L);
+	err = curl_easy_setopt(handle, CURLOPT_MAXREDIRS, 2L);
 	if(err != CURLE_OK)
 	{
 		mStatus = REQ_IO_ERROR;
@@ -80,9 +348,9 @@ HttpReq::HttpReq(const std::string& url)
 	//starting with 7.85.0, CURLOPT_REDIR_PROTOCOLS is deprecated
 	// and CURLOPT_REDIR_PROTOCOLS_STR should be used instead
 #if CURL_AT_LEAST_VERSION(7,85,0)
-	err = curl_easy_setopt(mHandle, CURLOPT_REDIR_PROTOCOLS_STR, "http,https");
+	err = curl_easy_setopt(handle, CURLOPT_REDIR_PROTOCOLS_STR, "http,https");
 #else
-	err = curl_easy_setopt(mHandle, CURLOPT_REDIR_PROTOCOLS, CURLPROTO_HTTP | CURLPROTO_HTTPS);
+	err = curl_easy_setopt(handle, CURLOPT_REDIR_PROTOCOLS, CURLPROTO_HTTP | CURLPROTO_HTTPS);
 #endif
 	if(err != CURLE_OK)
 	{
@@ -92,7 +360,7 @@ HttpReq::HttpReq(const std::string& url)
 	}
 
 	//tell curl how to write the data
-	err = curl_easy_setopt(mHandle, CURLOPT_WRITEFUNCTION, &HttpReq::write_content);
+	err = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &HttpReq::write_content);
 	if(err != CURLE_OK)
 	{
 		mStatus = REQ_IO_ERROR;
@@ -100,8 +368,8 @@ HttpReq::HttpReq(const std::string& url)
 		return;
 	}
 
-	//give curl a pointer to this HttpReq so we know where to write the data *to* in our write function
-	err = curl_easy_setopt(mHandle, CURLOPT_WRITEDATA, this);
+	//give curl a pointer to the transfer so we know where to write the data *to* in our write function
+	err = curl_easy_setopt(handle, CURLOPT_WRITEDATA, mTransfer.get());
 	if(err != CURLE_OK)
 	{
 		mStatus = REQ_IO_ERROR;
@@ -109,30 +377,53 @@ HttpReq::HttpReq(const std::string& url)
 		return;
 	}
 
-	//add the handle to our multi
-	CURLMcode merr = curl_multi_add_handle(s_multi_handle, mHandle);
-	if(merr != CURLM_OK)
+	//wait for a connection to the host that can multiplex rather than opening another one
+	curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
+	if(!mCacheUrl.empty())
 	{
-		mStatus = REQ_IO_ERROR;
-		onError(curl_multi_strerror(merr));
-		return;
+		curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &HttpReq::write_header);
+		curl_easy_setopt(handle, CURLOPT_HEADERDATA, mTransfer.get());
+
+		if(!mCachePath.empty())
+		{
+			if(!cachedResponse.etag.empty())
+				mTransfer->headers = curl_slist_append(mTransfer->headers, ("If-None-Match: " + cachedResponse.etag).c_str());
+			if(!cachedResponse.lastModified.empty())
+				mTransfer->headers = curl_slist_append(mTransfer->headers, ("If-Modified-Since: " + cachedResponse.lastModified).c_str());
+			curl_easy_setopt(handle, CURLOPT_HTTPHEADER, mTransfer->headers);
+		}
+	}
+
+	if(!saveAs.empty())
+	{
+		mTransfer->file.open(saveAs, std::ios_base::out | std::ios_base::binary);
+		if(!mTransfer->file.is_open())
+		{
+			mStatus = REQ_IO_ERROR;
+			onError("Failed to open the file to write. Permission error? Disk full?");
+			return;
+		}
 	}
 
-	s_requests[mHandle] = this;
+	HttpThread::getInstance().submit(mTransfer);
 }
 
 HttpReq::~HttpReq()
 {
-	if(mHandle)
+	if(mTransfer->status.load(std::memory_order_acquire) == REQ_IN_PROGRESS)
 	{
-		s_requests.erase(mHandle);
-
-		CURLMcode merr = curl_multi_remove_handle(s_multi_handle, mHandle);
-
-		if(merr != CURLM_OK)
-			LOG(LogError) << "Error removing curl_easy handle from curl_multi: " << curl_multi_strerror(merr);
+		// the network thread owns the handle, it cleans up once it sees the cancel
+		if(mStatus == REQ_IN_PROGRESS)
+		{
+			HttpThread::getInstance().cancel(mTransfer);
+			return;
+		}
 
-		curl_easy_cleanup(mHandle);
+		// never submitted
+		if(mTransfer->handle)
+			curl_easy_cleanup(mTransfer->handle);
+		curl_slist_free_all(mTransfer->headers);
 	}
 }
 
@@ -140,47 +431,64 @@ HttpReq::Status HttpReq::status()
 {
 	if(mStatus == REQ_IN_PROGRESS)
 	{
-		int handle_count;
-		CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
-		if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
+		mStatus = mTransfer->status.load(std::memory_order_acquire);
+		if(mStatus == REQ_SUCCESS && !mCacheUrl.empty())
+			updateCache();
+		else if(mStatus != REQ_IN_PROGRESS && mStatus != REQ_SUCCESS)
+			onError(mTransfer->error.c_str());
+	}
+
+	return mStatus;
+}
+
+void HttpReq::updateCache()
+{
+	HttpCache& cache = HttpCache::getInstance();
+
+	if(mTransfer->responseCode == 304 && !mCachePath.empty())
+	{
+		if(loadCached(mCachePath))
 		{
+			cache.notModified(mCacheUrl, mTransfer->cacheControl);
+		}else{
 			mStatus = REQ_IO_ERROR;
-			onError(curl_multi_strerror(merr));
-			return mStatus;
+			onError("Failed to read the cached response");
 		}
+	}
+	else if(mTransfer->responseCode == 200)
+	{
+		if(mTransfer->savePath.empty())
+			cache.store(mCacheUrl, mTransfer->content, mTransfer->etag, mTransfer->lastModified, mTransfer->cacheControl);
+		else
+			cache.storeFile(mCacheUrl, mTransfer->savePath, mTransfer->etag, mTransfer->lastModified, mTransfer->cacheControl);
+	}
+}
 
-		int msgs_left;
-		CURLMsg* msg;
-		while((msg = curl_multi_info_read(s_multi_handle, &msgs_left)) != nullptr)
-		{
-			if(msg->msg == CURLMSG_DONE)
-			{
-				HttpReq* req = s_requests[msg->easy_handle];
-
-				if(req == NULL)
-				{
-					LOG(LogError) << "Cannot find easy handle!";
-					continue;
-				}
+bool HttpReq::loadCached(const std::string& path)
+{
+	std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+	if(!in.is_open())
+		return false;
 
-				if(msg->data.result == CURLE_OK)
-				{
-					req->mStatus = REQ_SUCCESS;
-				}else{
-					req->mStatus = REQ_IO_ERROR;
-					req->onError(curl_easy_strerror(msg->data.result));
-				}
-			}
-		}
+	if(!mTransfer->savePath.empty())
+	{
+		std::ofstream out(mTransfer->savePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if(in.peek() != EOF)
+			out << in.rdbuf();
+		out.close();
+		return !out.fail();
 	}
 
-	return mStatus;
+	const long long size = Utils::FileSystem::getFileSize(path);
+	mTransfer->content.resize(size > 0 ? (size_t)size : 0);
+	in.read(&mTransfer->content[0], mTransfer->content.size());
+	return (size_t)in.gcount() == mTransfer->content.size();
 }
 
-std::string HttpReq::getContent() const
+const std::string& HttpReq::getContent() const
 {
 	assert(mStatus == REQ_SUCCESS);
-	return mContent.str();
+	return mTransfer->content;
 }
 
 void HttpReq::onError(const char* msg)
@@ -196,14 +504,70 @@ std::string HttpReq::getErrorMsg()
 //used as a curl callback
 //size = size of an element, nmemb = number of elements
 //return value is number of elements successfully read
-size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_ptr)
+//runs on the network thread
+size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* transfer_ptr)
 {
-	std::stringstream& ss = ((HttpReq*)req_ptr)->mContent;
-	ss.write((char*)buff, size * nmemb);
+	HttpTransfer* transfer = (HttpTransfer*)transfer_ptr;
+
+	if(transfer->file.is_open())
+	{
+		transfer->file.write((char*)buff, size * nmemb);
+		return transfer->file.fail() ? 0 : nmemb;
+	}
+
+	// size the buffer once from the response header rather than growing it chunk by chunk
+	if(transfer->content.empty())
+	{
+#if CURL_AT_LEAST_VERSION(7,55,0)
+		curl_off_t length = -1;
+		if(curl_easy_getinfo(transfer->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK && length > 0)
+			transfer->content.reserve((size_t)length);
+#else
+		double length = -1;
+		if(curl_easy_getinfo(transfer->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length) == CURLE_OK && length > 0)
+			transfer->content.reserve((size_t)length);
+#endif
+	}
+
+	transfer->content.append((char*)buff, size * nmemb);
 
 	return nmemb;
 }
 
+//used as a curl callback, runs on the network thread
+size_t HttpReq::write_header(char* buff, size_t size, size_t nitems, void* transfer_ptr)
+{
+	HttpTransfer* transfer = (HttpTransfer*)transfer_ptr;
+	std::string line(buff, size * nitems);
+	while(!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+		line.pop_back();
+
+	// a new response, after a redirect
+	if(line.compare(0, 5, "HTTP/") == 0)
+	{
+		transfer->etag.clear();
+		transfer->lastModified.clear();
+		transfer->cacheControl.clear();
+		return nitems;
+	}
+
+	const size_t colon = line.find(':');
+	if(colon == std::string::npos)
+		return nitems;
+
+	const std::string name = Utils::String::toLower(line.substr(0, colon));
+	const std::string value = Utils::String::trim(line.substr(colon + 1));
+
+	if(name == "etag")
+		transfer->etag = value;
+	else if(name == "last-modified")
+		transfer->lastModified = value;
+	else if(name == "cache-control")
+		transfer->cacheControl = value;
+
+	return nitems;
+}
+
 //used as a curl callback
 /*int HttpReq::update_progress(void* req_ptr, double dlTotal, double dlNow, double ulTotal, double ulNow)
 {
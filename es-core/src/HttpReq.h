@@ -3,8 +3,8 @@
 #define ES_CORE_HTTP_REQ_H
 
 #include <curl/curl.h>
-#include <map>
-#include <sstream>
+#include <memory>
+#include <string>
 
 /* Usage:
  * HttpReq myRequest("www.google.com", "/index.html");
@@ -21,12 +21,20 @@
  *
  * std::string content = myRequest.getContent();
  * //process contents...
+ *
+ * The transfers themselves run on a network thread, status() only reads where they are,
+ * so they keep going when nothing polls them (slow frames, the screensaver).
 */
 
+class HttpTransfer;
+
 class HttpReq
 {
 public:
-	HttpReq(const std::string& url);
+	// with saveAs the body is written straight to that file instead of being kept in memory,
+	// getContent() is then empty
+	// cached requests are answered from the HttpCache when it has a fresh response
+	HttpReq(const std::string& url, const std::string& saveAs = "", bool cached = false);
 
 	~HttpReq();
 
@@ -40,33 +48,33 @@ public:
 		REQ_INVALID_RESPONSE	//the HTTP response was invalid
 	};
 
-	Status status(); //process any received data and return the status afterwards
+	Status status(); //return the status of the transfer
 
 	std::string getErrorMsg();
 
-	std::string getContent() const; // mStatus must be REQ_SUCCESS
+	const std::string& getContent() const; // mStatus must be REQ_SUCCESS
 
 	static std::string urlEncode(const std::string &s);
 	static bool isUrl(const std::string& s);
 
 private:
-	static size_t write_content(void* buff, size_t size, size_t nmemb, void* req_ptr);
+	static size_t write_content(void* buff, size_t size, size_t nmemb, void* transfer_ptr);
+	static size_t write_header(char* buff, size_t size, size_t nitems, void* transfer_ptr);
 	//static int update_progress(void* req_ptr, double dlTotal, double dlNow, double ulTotal, double ulNow);
 
-	//god dammit libcurl why can't you have some way to check the status of an individual handle
-	//why do I have to handle ALL messages at once
-	static std::map<CURL*, HttpReq*> s_requests;
-
-	static CURLM* s_multi_handle;
-
 	void onError(const char* msg);
+	void updateCache();
+	bool loadCached(const std::string& path);
 
-	CURL* mHandle;
+	// shared with the network thread, which keeps it until it is done with the handle
+	std::shared_ptr<HttpTransfer> mTransfer;
 
 	Status mStatus;
 
-	std::stringstream mContent;
 	std::string mErrorMsg;
+
+	std::string mCacheUrl;  // empty unless the request goes through the cache
+	std::string mCachePath; // stale cached response being revalidated
 };
 
 #endif // ES_CORE_HTTP_REQ_H
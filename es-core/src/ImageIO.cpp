@@ -2,21 +2,74 @@
 
 #include "Log.h"
 #include <FreeImage.h>
+#include <stdio.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define IMAGEIO_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMAGEIO_NEON
+#include <arm_neon.h>
+#endif
+
 std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height)
+{
+	size_t sourceWidth, sourceHeight;
+	return loadFromMemoryRGBA32(data, size, width, height, 0, 0, sourceWidth, sourceHeight);
+}
+
+// how many times the image can be halved and still cover maxWidth x maxHeight
+static int getHalvings(size_t width, size_t height, const size_t maxWidth, const size_t maxHeight)
+{
+	int halvings = 0;
+	if (maxWidth == 0 && maxHeight == 0)
+		return halvings;
+
+	while ((width / 2) >= maxWidth && (height / 2) >= maxHeight && width >= 2 && height >= 2)
+	{
+		width /= 2;
+		height /= 2;
+		halvings++;
+	}
+	return halvings;
+}
+
+std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, const size_t maxWidth, const size_t maxHeight, size_t & sourceWidth, size_t & sourceHeight)
 {
 	std::vector<unsigned char> rawData;
 	width = 0;
 	height = 0;
+	sourceWidth = 0;
+	sourceHeight = 0;
 	FIMEMORY * fiMemory = FreeImage_OpenMemory((BYTE *)data, (DWORD)size);
 	if (fiMemory != nullptr) {
 		//detect the filetype from data
 		FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(fiMemory);
 		if (format != FIF_UNKNOWN && FreeImage_FIFSupportsReading(format))
 		{
+			int flags = 0;
+
+			//jpeg can be scaled down by 2, 4 or 8 while decoding, which is much cheaper than decoding it all.
+			//read just the header to find out by how much, the decoder is asked for the size of the larger side
+			if (format == FIF_JPEG && (maxWidth != 0 || maxHeight != 0))
+			{
+				FIBITMAP * fiHeader = FreeImage_LoadFromMemory(format, fiMemory, FIF_LOAD_NOPIXELS);
+				if (fiHeader != nullptr)
+				{
+					sourceWidth = FreeImage_GetWidth(fiHeader);
+					sourceHeight = FreeImage_GetHeight(fiHeader);
+					FreeImage_Unload(fiHeader);
+
+					const int halvings = getHalvings(sourceWidth, sourceHeight, maxWidth, maxHeight);
+					if (halvings > 0)
+						flags = (int)((sourceWidth > sourceHeight ? sourceWidth : sourceHeight) >> halvings) << 16;
+				}
+				FreeImage_SeekMemory(fiMemory, 0, SEEK_SET);
+			}
+
 			//file type is supported. load image
-			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory);
+			FIBITMAP * fiBitmap = FreeImage_LoadFromMemory(format, fiMemory, flags);
 			if (fiBitmap != nullptr)
 			{
 				//loaded. convert to 32bit if necessary
@@ -34,29 +87,31 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 				{
 					width = FreeImage_GetWidth(fiBitmap);
 					height = FreeImage_GetHeight(fiBitmap);
-					//loop through scanlines and add all pixel data to the return vector
-					//this is necessary, because width*height*bpp might not be == pitch
-					unsigned char * tempData = new unsigned char[width * height * 4];
-					for (size_t i = 0; i < height; i++)
+					if (sourceWidth == 0 || sourceHeight == 0)
 					{
-						const BYTE * scanLine = FreeImage_GetScanLine(fiBitmap, (int)i);
-						memcpy(tempData + (i * width * 4), scanLine, width * 4);
+						sourceWidth = width;
+						sourceHeight = height;
 					}
-					//convert from BGRA to RGBA
-					for(size_t i = 0; i < width*height; i++)
+					//copy the scanlines straight into the return vector, converting from BGRA to RGBA on the way
+					//this is done per scanline, because width*height*bpp might not be == pitch
+					rawData.resize(width * height * 4);
+					for (size_t i = 0; i < height; i++)
 					{
-						RGBQUAD bgra = ((RGBQUAD *)tempData)[i];
-						RGBQUAD rgba;
-						rgba.rgbBlue = bgra.rgbRed;
-						rgba.rgbGreen = bgra.rgbGreen;
-						rgba.rgbRed = bgra.rgbBlue;
-						rgba.rgbReserved = bgra.rgbReserved;
-						((RGBQUAD *)tempData)[i] = rgba;
+						const BYTE * scanLine = FreeImage_GetScanLine(fiBitmap, (int)i);
+						swizzleBGRA(scanLine, rawData.data() + (i * width * 4), width);
 					}
-					rawData = std::vector<unsigned char>(tempData, tempData + width * height * 4);
 					//free bitmap data
 					FreeImage_Unload(fiBitmap);
-					delete[] tempData;
+
+					//whatever the decoder couldn't scale away is halved here
+					for (int i = getHalvings(width, height, maxWidth, maxHeight); i > 0; i--)
+					{
+						std::vector<unsigned char> halved((width / 2) * (height / 2) * 4);
+						downscaleHalf(rawData.data(), width, height, halved.data());
+						rawData.swap(halved);
+						width /= 2;
+						height /= 2;
+					}
 				}
 			}
 			else
@@ -76,15 +131,99 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 
 void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height)
 {
-	unsigned int temp;
-	unsigned int* arr = (unsigned int*)imagePx;
+	//swap whole rows, memcpy is already as wide as the target allows
+	const size_t rowSize = width * 4;
+	std::vector<unsigned char> temp(rowSize);
 	for(size_t y = 0; y < height / 2; y++)
 	{
-		for(size_t x = 0; x < width; x++)
+		unsigned char* top = imagePx + (y * rowSize);
+		unsigned char* bottom = imagePx + ((height - 1 - y) * rowSize);
+		memcpy(temp.data(), top, rowSize);
+		memcpy(top, bottom, rowSize);
+		memcpy(bottom, temp.data(), rowSize);
+	}
+}
+
+void ImageIO::swizzleBGRA(const unsigned char* src, unsigned char* dst, const size_t count)
+{
+	size_t i = 0;
+
+#if defined(IMAGEIO_SSE2)
+	//red and blue are bytes 0 and 2 of each pixel, shifting the two 16 bit halves past each other swaps them
+	const __m128i maskAG = _mm_set1_epi32(0xFF00FF00);
+	const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i px = _mm_loadu_si128((const __m128i*)(src + (i * 4)));
+		const __m128i ag = _mm_and_si128(px, maskAG);
+		const __m128i rb = _mm_and_si128(px, maskRB);
+		_mm_storeu_si128((__m128i*)(dst + (i * 4)), _mm_or_si128(ag, _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16))));
+	}
+#elif defined(IMAGEIO_NEON)
+	for(; i + 16 <= count; i += 16)
+	{
+		uint8x16x4_t px = vld4q_u8(src + (i * 4));
+		const uint8x16_t b = px.val[0];
+		px.val[0] = px.val[2];
+		px.val[2] = b;
+		vst4q_u8(dst + (i * 4), px);
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		const unsigned char b = src[(i * 4) + 0];
+		dst[(i * 4) + 0] = src[(i * 4) + 2];
+		dst[(i * 4) + 1] = src[(i * 4) + 1];
+		dst[(i * 4) + 2] = b;
+		dst[(i * 4) + 3] = src[(i * 4) + 3];
+	}
+}
+
+void ImageIO::downscaleHalf(const unsigned char* src, const size_t& width, const size_t& height, unsigned char* dst)
+{
+	const size_t dstWidth = width / 2;
+	const size_t dstHeight = height / 2;
+
+	for(size_t y = 0; y < dstHeight; y++)
+	{
+		const unsigned char* row0 = src + ((y * 2) * width * 4);
+		const unsigned char* row1 = row0 + (width * 4);
+		unsigned char* out = dst + (y * dstWidth * 4);
+		size_t x = 0;
+
+#if defined(IMAGEIO_SSE2)
+		//average the two rows, then each pair of neighbouring pixels, 4 source pixels at a time
+		for(; x + 2 <= dstWidth; x += 2)
+		{
+			const __m128i v = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(row0 + (x * 8))), _mm_loadu_si128((const __m128i*)(row1 + (x * 8))));
+			const __m128i even = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128i odd = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 1, 3, 1));
+			_mm_storel_epi64((__m128i*)(out + (x * 4)), _mm_avg_epu8(even, odd));
+		}
+#elif defined(IMAGEIO_NEON)
+		//sum the two rows and each pair of neighbouring pixels per channel, 8 source pixels at a time
+		for(; x + 4 <= dstWidth; x += 4)
+		{
+			const uint8x16_t r0 = vld1q_u8(row0 + (x * 8));
+			const uint8x16_t r1 = vld1q_u8(row1 + (x * 8));
+			const uint8x16_t r2 = vld1q_u8(row0 + (x * 8) + 16);
+			const uint8x16_t r3 = vld1q_u8(row1 + (x * 8) + 16);
+			const uint16x8_t lo = vaddq_u16(vmovl_u8(vget_low_u8(r0)), vmovl_u8(vget_low_u8(r1)));
+			const uint16x8_t hi = vaddq_u16(vmovl_u8(vget_high_u8(r0)), vmovl_u8(vget_high_u8(r1)));
+			const uint16x8_t lo2 = vaddq_u16(vmovl_u8(vget_low_u8(r2)), vmovl_u8(vget_low_u8(r3)));
+			const uint16x8_t hi2 = vaddq_u16(vmovl_u8(vget_high_u8(r2)), vmovl_u8(vget_high_u8(r3)));
+			//each half holds two pixels, add the first pixel's channels to the second's
+			const uint16x8_t sum0 = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)), vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+			const uint16x8_t sum1 = vcombine_u16(vadd_u16(vget_low_u16(lo2), vget_high_u16(lo2)), vadd_u16(vget_low_u16(hi2), vget_high_u16(hi2)));
+			vst1q_u8(out + (x * 4), vcombine_u8(vrshrn_n_u16(sum0, 2), vrshrn_n_u16(sum1, 2)));
+		}
+#endif
+
+		for(; x < dstWidth; x++)
 		{
-			temp = arr[x + (y * width)];
-			arr[x + (y * width)] = arr[x + (height * width) - ((y + 1) * width)];
-			arr[x + (height * width) - ((y + 1) * width)] = temp;
+			for(size_t c = 0; c < 4; c++)
+				out[(x * 4) + c] = (unsigned char)((row0[(x * 8) + c] + row0[(x * 8) + 4 + c] + row1[(x * 8) + c] + row1[(x * 8) + 4 + c] + 2) / 4);
 		}
 	}
 }
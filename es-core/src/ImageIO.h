@@ -9,7 +9,14 @@ class ImageIO
 {
 public:
 	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height);
+	// Decodes at the smallest size that still covers maxWidth x maxHeight (0 = no limit on that axis), halving
+	// the image and using the decoder's own scaling where it has one. sourceWidth and sourceHeight return the full size
+	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height, const size_t maxWidth, const size_t maxHeight, size_t & sourceWidth, size_t & sourceHeight);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
+
+	// Pixel kernels, use SSE2 or NEON when the target has them
+	static void swizzleBGRA(const unsigned char* src, unsigned char* dst, const size_t count); // swaps red and blue of count pixels, src and dst may be the same
+	static void downscaleHalf(const unsigned char* src, const size_t& width, const size_t& height, unsigned char* dst); // 2x2 box filter into a (width / 2) x (height / 2) image
 };
 
 #endif // ES_CORE_IMAGE_IO
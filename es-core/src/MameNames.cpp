@@ -110,6 +110,13 @@ MameNames::~MameNames()
 } // ~MameNames
 
 std::string MameNames::getRealName(const std::string& _mameName)
+{
+	const std::string* realName = findRealName(_mameName);
+	return realName ? *realName : _mameName;
+
+} // getRealName
+
+const std::string* MameNames::findRealName(const std::string& _mameName)
 {
 	size_t start = 0;
 	size_t end   = mNamePairs.size();
@@ -121,12 +128,12 @@ std::string MameNames::getRealName(const std::string& _mameName)
 
 		if(compare < 0)       start = index + 1;
 		else if( compare > 0) end   = index;
-		else                  return mNamePairs[index].realName;
+		else                  return &mNamePairs[index].realName;
 	}
 
-	return _mameName;
+	return nullptr;
 
-} // getRealName
+} // findRealName
 
 const bool MameNames::isBios(const std::string& _biosName)
 {
@@ -140,7 +147,7 @@ const bool MameNames::isDevice(const std::string& _deviceName)
 
 } // isDevice
 
-const bool MameNames::find(std::vector<std::string> devices, const std::string& name)
+const bool MameNames::find(const std::vector<std::string>& devices, const std::string& name)
 {
 	size_t start = 0;
 	size_t end   = devices.size();
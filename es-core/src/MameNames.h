@@ -13,6 +13,8 @@ public:
 	static void       deinit     ();
 	static MameNames* getInstance();
 	std::string       getRealName(const std::string& _mameName);
+	// as above, but returns the name held by MameNames or nullptr if there is none, valid until deinit
+	const std::string* findRealName(const std::string& _mameName);
 	const bool        isBios(const std::string& _biosName);
 	const bool        isDevice(const std::string& _deviceName);
 
@@ -35,7 +37,7 @@ private:
 	std::vector<std::string> mMameBioses;
 	std::vector<std::string> mMameDevices;
 
-	const bool find(const std::vector<std::string> devices, const std::string& name);
+	const bool find(const std::vector<std::string>& devices, const std::string& name);
 
 }; // MameNames
 
@@ -60,6 +60,11 @@ void Settings::setDefaults()
 	mBoolMap["ParseGamelistOnly"] = false;
 	mBoolMap["ShowHiddenFiles"] = false;
 	mBoolMap["DrawFramerate"] = false;
+	mBoolMap["SkipIdleFrames"] = true;
+	mBoolMap["TextureAtlas"] = true;
+	mBoolMap["TextureCache"] = false;
+	mIntMap["TextureCacheSize"] = 512; // MB of decoded images kept in ~/.emulationstation/cache/textures, 0 for no limit
+	mBoolMap["ThemeCache"] = false;
 	mBoolMap["ShowExit"] = true;
 	mBoolMap["ConfirmQuit"] = true;
 	mBoolMap["FullscreenBorderless"] = false;
@@ -91,11 +96,14 @@ void Settings::setDefaults()
 	mBoolMap["SystemSleepTimeHintDisplayed"] = false;
 	mIntMap["ScraperResizeWidth"] = 400;
 	mIntMap["ScraperResizeHeight"] = 0;
+	mIntMap["ScraperCacheSize"] = 256; // MB of scraper responses kept in ~/.emulationstation/cache/http, 0 disables it
 	#ifdef _RPI_
 		mIntMap["MaxVRAM"] = 80;
 	#else
 		mIntMap["MaxVRAM"] = 100;
 	#endif
+	mIntMap["MaxTextureRAM"] = 0; // MB of decoded texture pixels kept in RAM, 0 leaves it to MaxVRAM
+	mIntMap["PrefetchVRAM"] = 20; // percent of MaxVRAM gamelists may fill with media decoded ahead of the cursor, 0 disables it
 
 	mStringMap["TransitionStyle"] = "fade";
 	mStringMap["ThemeSet"] = "";
@@ -171,6 +179,7 @@ void Settings::setDefaults()
 	mBoolMap["ForceKiosk"] = false;
 	mBoolMap["ForceKid"] = false;
 	mBoolMap["ForceDisableFilters"] = false;
+	mBoolMap["SearchMetadata"] = false; // also search developer and genre
 
 	mIntMap["WindowWidth"]   = 0;
 	mIntMap["WindowHeight"]  = 0;
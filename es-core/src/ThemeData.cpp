@@ -9,6 +9,15 @@
 #include "Settings.h"
 #include <pugixml.hpp>
 #include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
 
 std::vector<std::string> ThemeData::sSupportedViews { { "system" }, { "basic" }, { "detailed" }, { "grid" }, { "video" } };
 std::vector<std::string> ThemeData::sSupportedFeatures { { "video" }, { "carousel" }, { "z-index" }, { "visible" } };
@@ -222,6 +231,258 @@ std::string ThemeData::resolvePlaceholders(const char* in)
 	return prefix + mVariables[replace] + suffix;
 }
 
+struct ThemeDocument
+{
+	std::weak_ptr<const pugi::xml_document> document;
+	long long                               size;
+	long long                               modified;
+};
+
+static std::map<std::string, ThemeDocument> sDocuments;
+static std::mutex sDocumentsMutex;
+
+std::shared_ptr<const pugi::xml_document> ThemeData::getDocument(const std::string& path, std::string& error_out)
+{
+	const long long size = Utils::FileSystem::getFileSize(path);
+	const long long modified = Utils::FileSystem::getModificationTime(path);
+
+	{
+		std::unique_lock<std::mutex> lock(sDocumentsMutex);
+		auto it = sDocuments.find(path);
+		if(it != sDocuments.cend() && it->second.size == size && it->second.modified == modified)
+		{
+			std::shared_ptr<const pugi::xml_document> document = it->second.document.lock();
+			if(document != nullptr)
+				return document;
+		}
+	}
+
+	// parse outside of the lock, systems load their themes in parallel
+	std::shared_ptr<pugi::xml_document> document = std::make_shared<pugi::xml_document>();
+	pugi::xml_parse_result result = document->load_file(path.c_str());
+	if(!result)
+	{
+		error_out = result.description();
+		return nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(sDocumentsMutex);
+	ThemeDocument& entry = sDocuments[path];
+	std::shared_ptr<const pugi::xml_document> existing = entry.document.lock();
+	if(existing != nullptr && entry.size == size && entry.modified == modified)
+		return existing;
+
+	entry.document = document;
+	entry.size = size;
+	entry.modified = modified;
+
+	// forget files no theme uses anymore
+	for(auto it = sDocuments.begin(); it != sDocuments.end(); )
+	{
+		if(it->second.document.expired())
+			it = sDocuments.erase(it);
+		else
+			++it;
+	}
+
+	return document;
+}
+
+// names of the ThemeProperty ids, in the same order
+static const char* const sPropertyNames[ThemeProperty::COUNT] = {
+	"alignment",
+	"animate",
+	"autoLayout",
+	"autoLayoutSelectedZoom",
+	"backgroundCenterColor",
+	"backgroundColor",
+	"backgroundCornerSize",
+	"backgroundEdgeColor",
+	"backgroundImage",
+	"centerSelection",
+	"color",
+	"colorEnd",
+	"default",
+	"delay",
+	"displayRelative",
+	"filledPath",
+	"folderImage",
+	"fontPath",
+	"fontSize",
+	"forceUppercase",
+	"format",
+	"gameImage",
+	"gradientType",
+	"horizontalMargin",
+	"iconColor",
+	"imageColor",
+	"imageSource",
+	"lineSpacing",
+	"logoAlignment",
+	"logoRotation",
+	"logoRotationOrigin",
+	"logoScale",
+	"logoSize",
+	"margin",
+	"maxLogoCount",
+	"maxSize",
+	"minLogoOpacity",
+	"minSize",
+	"origin",
+	"padding",
+	"path",
+	"pos",
+	"primaryColor",
+	"rotation",
+	"rotationOrigin",
+	"scaledLogoSpacing",
+	"scrollDirection",
+	"scrollLoop",
+	"scrollSound",
+	"secondaryColor",
+	"selectedColor",
+	"selectorColor",
+	"selectorColorEnd",
+	"selectorGradientType",
+	"selectorHeight",
+	"selectorImagePath",
+	"selectorImageTile",
+	"selectorOffsetY",
+	"showSnapshotDelay",
+	"showSnapshotNoVideo",
+	"size",
+	"text",
+	"textColor",
+	"tile",
+	"type",
+	"unfilledPath",
+	"value",
+	"visible",
+	"zIndex",
+};
+
+unsigned short ThemeData::ThemeElement::getPropertyId(const std::string& name)
+{
+	static const std::unordered_map<std::string, unsigned short> ids = []
+	{
+		std::unordered_map<std::string, unsigned short> map;
+		for(unsigned short id = 0; id < ThemeProperty::COUNT; id++)
+			map[sPropertyNames[id]] = id;
+
+		// a property an element type declares without an id would be dropped when the theme is parsed
+		for(auto elemIt = sElementMap.cbegin(); elemIt != sElementMap.cend(); ++elemIt)
+			for(auto propIt = elemIt->second.cbegin(); propIt != elemIt->second.cend(); ++propIt)
+				if(map.find(propIt->first) == map.cend())
+					LOG(LogError) << "Theme property \"" << propIt->first << "\" has no ThemeProperty id";
+
+		return map;
+	}();
+
+	auto it = ids.find(name);
+	if(it == ids.cend())
+		return INVALID_PROPERTY;
+
+	return it->second;
+}
+
+const std::string& ThemeData::ThemeElement::getPropertyName(unsigned short id)
+{
+	static const std::vector<std::string> names(sPropertyNames, sPropertyNames + ThemeProperty::COUNT);
+	static const std::string empty;
+
+	if(id >= names.size())
+		return empty;
+
+	return names[id];
+}
+
+const ThemeData::ThemeElement::Property* ThemeData::ThemeElement::find(unsigned short id) const
+{
+	auto it = std::lower_bound(properties.cbegin(), properties.cend(), id, [](const Property& p, unsigned short value) { return p.id < value; });
+	return (it != properties.cend() && it->id == id) ? &(*it) : nullptr;
+}
+
+const ThemeData::ThemeElement::Property& ThemeData::ThemeElement::at(const std::string& prop) const
+{
+	const Property* property = find(getPropertyId(prop));
+	if(property == nullptr)
+		throw std::out_of_range("ThemeElement has no property \"" + prop + "\"");
+	return *property;
+}
+
+const ThemeData::ThemeElement::Property& ThemeData::ThemeElement::at(ThemeProperty::Id prop) const
+{
+	const Property* property = find(prop);
+	if(property == nullptr)
+		throw std::out_of_range("ThemeElement has no property \"" + getPropertyName(prop) + "\"");
+	return *property;
+}
+
+ThemeData::ThemeElement::Property& ThemeData::ThemeElement::insert(unsigned short id, Property::Type type)
+{
+	auto it = std::lower_bound(properties.begin(), properties.end(), id, [](const Property& p, unsigned short value) { return p.id < value; });
+	if(it == properties.end() || it->id != id)
+	{
+		// the whole union is written to the theme cache, don't leave any of it uninitialized
+		Property property;
+		property.id = id;
+		property.type = type;
+		memset(property.r, 0, sizeof(property.r));
+		it = properties.insert(it, property);
+	}
+	else if(it->type != type)
+	{
+		it->type = type;
+		memset(it->r, 0, sizeof(it->r));
+	}
+	return *it;
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const Vector4f& value)
+{
+	Property& property = insert(id, Property::RECT);
+	property.r[0] = value.x();
+	property.r[1] = value.y();
+	property.r[2] = value.z();
+	property.r[3] = value.w();
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const Vector2f& value)
+{
+	Property& property = insert(id, Property::PAIR);
+	property.v[0] = value.x();
+	property.v[1] = value.y();
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const std::string& value)
+{
+	// an overridden string keeps its slot
+	Property* property = const_cast<Property*>(find(id));
+	if(property != nullptr && property->type == Property::STRING)
+	{
+		strings[property->i] = value;
+		return;
+	}
+
+	insert(id, Property::STRING).i = (unsigned int)strings.size();
+	strings.push_back(value);
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const unsigned int& value)
+{
+	insert(id, Property::COLOR).i = value;
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const float& value)
+{
+	insert(id, Property::FLOAT).f = value;
+}
+
+void ThemeData::ThemeElement::set(unsigned short id, const bool& value)
+{
+	insert(id, Property::BOOLEAN).b = value;
+}
+
 ThemeData::ThemeData()
 {
 	mVersion = 0;
@@ -242,15 +503,24 @@ void ThemeData::loadFile(std::map<std::string, std::string> sysDataMap, const st
 	mResolution = { 1, 1 };
 	mViews.clear();
 	mVariables.clear();
+	mFiles.clear();
+	mDocuments.clear();
+
+	const bool useCache = Settings::getInstance()->getBool("ThemeCache");
+	if(useCache && loadCache(sysDataMap, path))
+		return;
 
 	mVariables.insert(sysDataMap.cbegin(), sysDataMap.cend());
 
-	pugi::xml_document doc;
-	pugi::xml_parse_result res = doc.load_file(path.c_str());
-	if(!res)
-		throw error << "XML parsing error: \n    " << res.description();
+	std::string parseError;
+	std::shared_ptr<const pugi::xml_document> doc = getDocument(path, parseError);
+	if(doc == nullptr)
+		throw error << "XML parsing error: \n    " << parseError;
+
+	mFiles.push_back(path);
+	mDocuments.push_back(doc);
 
-	pugi::xml_node root = doc.child("theme");
+	pugi::xml_node root = doc->child("theme");
 	if(!root)
 		throw error << "Missing <theme> tag!";
 
@@ -283,6 +553,328 @@ void ThemeData::loadFile(std::map<std::string, std::string> sysDataMap, const st
 	parseIncludes(root);
 	parseViews(root);
 	parseFeatures(root);
+
+	if(useCache)
+		saveCache(sysDataMap, path);
+}
+
+#define THEME_CACHE_MAGIC "ESTH"
+#define THEME_CACHE_VERSION 1
+// sanity limits for entries read back from disk
+#define THEME_CACHE_MAX_COUNT 65536
+#define THEME_CACHE_MAX_STRING (1024 * 1024)
+
+static void writeCacheValue(std::ostream& stream, uint32_t value)
+{
+	stream.write((const char*)&value, sizeof(value));
+}
+
+static void writeCacheString(std::ostream& stream, const std::string& value)
+{
+	writeCacheValue(stream, (uint32_t)value.size());
+	stream.write(value.c_str(), value.size());
+}
+
+static bool readCacheValue(std::istream& stream, uint32_t& value_out, uint32_t max = THEME_CACHE_MAX_COUNT)
+{
+	return stream.read((char*)&value_out, sizeof(value_out)) && value_out <= max;
+}
+
+static bool readCacheString(std::istream& stream, std::string& value_out)
+{
+	uint32_t size;
+	if(!readCacheValue(stream, size, THEME_CACHE_MAX_STRING))
+		return false;
+
+	value_out.resize(size);
+	return (size == 0) || stream.read(&value_out[0], size);
+}
+
+// returns true if the cache entry can never be loaded again, because it is from another version or
+// one of the files it was built from is gone. Entries of other theme sets are kept for switching back
+static bool isCacheEntryStale(const std::string& cachePath)
+{
+	std::ifstream stream(cachePath, std::ios::binary);
+	if(!stream.is_open())
+		return false;
+
+	char magic[4];
+	uint32_t version;
+	if(!stream.read(magic, 4) || memcmp(magic, THEME_CACHE_MAGIC, 4) != 0 || !readCacheValue(stream, version) || version != THEME_CACHE_VERSION)
+		return true;
+
+	std::string entryPath;
+	uint32_t variableCount;
+	if(!readCacheString(stream, entryPath) || !readCacheValue(stream, variableCount))
+		return true;
+
+	for(uint32_t i = 0; i < variableCount; ++i)
+	{
+		std::string name, value;
+		if(!readCacheString(stream, name) || !readCacheString(stream, value))
+			return true;
+	}
+
+	uint32_t fileCount;
+	if(!readCacheValue(stream, fileCount))
+		return true;
+
+	for(uint32_t i = 0; i < fileCount; ++i)
+	{
+		std::string file;
+		int64_t size, modified;
+		if(!readCacheString(stream, file) || !stream.read((char*)&size, sizeof(size)) || !stream.read((char*)&modified, sizeof(modified)))
+			return true;
+
+		if(!Utils::FileSystem::exists(file))
+			return true;
+	}
+
+	return false;
+}
+
+void ThemeData::pruneCache()
+{
+	if(!Settings::getInstance()->getBool("ThemeCache"))
+		return;
+
+	const std::string directory = Utils::FileSystem::getHomePath() + "/.emulationstation/cache/themes";
+	const Utils::FileSystem::stringList files = Utils::FileSystem::getDirContent(directory);
+
+	unsigned int removed = 0;
+	for(auto it = files.cbegin(); it != files.cend(); ++it)
+	{
+		// anything but an entry is left over from an interrupted write
+		if((Utils::FileSystem::getExtension(*it) != ".bin" || isCacheEntryStale(*it)) && Utils::FileSystem::removeFile(*it))
+			removed++;
+	}
+
+	if(removed > 0)
+		LOG(LogInfo) << "Removed " << removed << " theme cache entries no theme uses anymore";
+}
+
+std::string ThemeData::getCachePath(const std::map<std::string, std::string>& sysDataMap, const std::string& path)
+{
+	std::string key = path;
+	for(auto it = sysDataMap.cbegin(); it != sysDataMap.cend(); ++it)
+		key += "\n" + it->first + "=" + it->second;
+
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long)std::hash<std::string>()(key);
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/cache/themes/" + ss.str() + ".bin";
+}
+
+bool ThemeData::loadCache(const std::map<std::string, std::string>& sysDataMap, const std::string& path)
+{
+	std::ifstream stream(getCachePath(sysDataMap, path), std::ios::binary);
+	if(!stream.is_open())
+		return false;
+
+	char magic[4];
+	uint32_t version;
+	if(!stream.read(magic, 4) || memcmp(magic, THEME_CACHE_MAGIC, 4) != 0 || !readCacheValue(stream, version) || version != THEME_CACHE_VERSION)
+		return false;
+
+	// different themes can end up with the same name, make sure this entry is for this one
+	std::string entryPath;
+	uint32_t variableCount;
+	if(!readCacheString(stream, entryPath) || entryPath != path || !readCacheValue(stream, variableCount) || variableCount != sysDataMap.size())
+		return false;
+
+	for(auto it = sysDataMap.cbegin(); it != sysDataMap.cend(); ++it)
+	{
+		std::string name, value;
+		if(!readCacheString(stream, name) || !readCacheString(stream, value) || name != it->first || value != it->second)
+			return false;
+	}
+
+	// any file that went into the entry changed since it was written
+	uint32_t fileCount;
+	if(!readCacheValue(stream, fileCount))
+		return false;
+
+	std::vector<std::string> files;
+	for(uint32_t i = 0; i < fileCount; ++i)
+	{
+		std::string file;
+		int64_t size, modified;
+		if(!readCacheString(stream, file) || !stream.read((char*)&size, sizeof(size)) || !stream.read((char*)&modified, sizeof(modified)))
+			return false;
+
+		if(size != Utils::FileSystem::getFileSize(file) || modified != Utils::FileSystem::getModificationTime(file))
+			return false;
+
+		files.push_back(file);
+	}
+
+	float themeVersion;
+	Vector2f resolution;
+	if(!stream.read((char*)&themeVersion, sizeof(themeVersion)) || !stream.read((char*)&resolution[0], sizeof(float) * 2))
+		return false;
+
+	std::map<std::string, ThemeView> views;
+	uint32_t viewCount;
+	if(!readCacheValue(stream, viewCount))
+		return false;
+
+	for(uint32_t v = 0; v < viewCount; ++v)
+	{
+		std::string viewName;
+		uint32_t keyCount, elementCount;
+		if(!readCacheString(stream, viewName) || !readCacheValue(stream, keyCount))
+			return false;
+
+		ThemeView& view = views[viewName];
+		view.orderedKeys.resize(keyCount);
+		for(uint32_t k = 0; k < keyCount; ++k)
+		{
+			if(!readCacheString(stream, view.orderedKeys[k]))
+				return false;
+		}
+
+		if(!readCacheValue(stream, elementCount))
+			return false;
+
+		for(uint32_t e = 0; e < elementCount; ++e)
+		{
+			std::string elementName;
+			uint32_t extra, propertyCount, stringCount;
+			if(!readCacheString(stream, elementName))
+				return false;
+
+			ThemeElement& element = view.elements[elementName];
+			if(!readCacheString(stream, element.type) || !readCacheValue(stream, extra) || !readCacheValue(stream, propertyCount))
+				return false;
+
+			element.extra = (extra != 0);
+			element.properties.resize(propertyCount);
+			for(uint32_t p = 0; p < propertyCount; ++p)
+			{
+				ThemeElement::Property& property = element.properties[p];
+				std::string propertyName;
+				uint32_t type;
+				if(!readCacheString(stream, propertyName) || !readCacheValue(stream, type, ThemeElement::Property::BOOLEAN) || !stream.read((char*)property.r, sizeof(property.r)))
+					return false;
+
+				// ids are only stable within one build, the entry stores names
+				property.id = ThemeElement::getPropertyId(propertyName);
+				property.type = (ThemeElement::Property::Type)type;
+				if(property.id == ThemeElement::INVALID_PROPERTY)
+					return false;
+			}
+			std::sort(element.properties.begin(), element.properties.end(), [](const ThemeElement::Property& a, const ThemeElement::Property& b) { return a.id < b.id; });
+
+			if(!readCacheValue(stream, stringCount))
+				return false;
+
+			element.strings.resize(stringCount);
+			for(uint32_t s = 0; s < stringCount; ++s)
+			{
+				if(!readCacheString(stream, element.strings[s]))
+					return false;
+			}
+
+			for(auto it = element.properties.cbegin(); it != element.properties.cend(); ++it)
+			{
+				if(it->type == ThemeElement::Property::STRING && it->i >= stringCount)
+					return false;
+			}
+		}
+	}
+
+	mVersion = themeVersion;
+	mResolution = resolution;
+	mViews.swap(views);
+	mFiles.swap(files);
+	return true;
+}
+
+void ThemeData::saveCache(const std::map<std::string, std::string>& sysDataMap, const std::string& path) const
+{
+	const std::string cachePath = getCachePath(sysDataMap, path);
+	const std::string tempPath = cachePath + ".tmp";
+
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(cachePath));
+
+	{
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		if(!stream.is_open())
+		{
+			LOG(LogWarning) << "Could not write theme cache entry " << cachePath;
+			return;
+		}
+
+		stream.write(THEME_CACHE_MAGIC, 4);
+		writeCacheValue(stream, THEME_CACHE_VERSION);
+		writeCacheString(stream, path);
+
+		writeCacheValue(stream, (uint32_t)sysDataMap.size());
+		for(auto it = sysDataMap.cbegin(); it != sysDataMap.cend(); ++it)
+		{
+			writeCacheString(stream, it->first);
+			writeCacheString(stream, it->second);
+		}
+
+		writeCacheValue(stream, (uint32_t)mFiles.size());
+		for(auto it = mFiles.cbegin(); it != mFiles.cend(); ++it)
+		{
+			const int64_t size = Utils::FileSystem::getFileSize(*it);
+			const int64_t modified = Utils::FileSystem::getModificationTime(*it);
+			writeCacheString(stream, *it);
+			stream.write((const char*)&size, sizeof(size));
+			stream.write((const char*)&modified, sizeof(modified));
+		}
+
+		stream.write((const char*)&mVersion, sizeof(mVersion));
+		stream.write((const char*)&mResolution[0], sizeof(float) * 2);
+
+		writeCacheValue(stream, (uint32_t)mViews.size());
+		for(auto viewIt = mViews.cbegin(); viewIt != mViews.cend(); ++viewIt)
+		{
+			const ThemeView& view = viewIt->second;
+			writeCacheString(stream, viewIt->first);
+
+			writeCacheValue(stream, (uint32_t)view.orderedKeys.size());
+			for(auto it = view.orderedKeys.cbegin(); it != view.orderedKeys.cend(); ++it)
+				writeCacheString(stream, *it);
+
+			writeCacheValue(stream, (uint32_t)view.elements.size());
+			for(auto elemIt = view.elements.cbegin(); elemIt != view.elements.cend(); ++elemIt)
+			{
+				const ThemeElement& element = elemIt->second;
+				writeCacheString(stream, elemIt->first);
+				writeCacheString(stream, element.type);
+				writeCacheValue(stream, element.extra ? 1 : 0);
+
+				writeCacheValue(stream, (uint32_t)element.properties.size());
+				for(auto it = element.properties.cbegin(); it != element.properties.cend(); ++it)
+				{
+					writeCacheString(stream, ThemeElement::getPropertyName(it->id));
+					writeCacheValue(stream, (uint32_t)it->type);
+					stream.write((const char*)it->r, sizeof(it->r));
+				}
+
+				writeCacheValue(stream, (uint32_t)element.strings.size());
+				for(auto it = element.strings.cbegin(); it != element.strings.cend(); ++it)
+					writeCacheString(stream, *it);
+			}
+		}
+
+		if(!stream.good())
+		{
+			stream.close();
+			remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	// readers never see a half written entry, windows won't rename over an existing file
+	if(rename(tempPath.c_str(), cachePath.c_str()) != 0)
+	{
+		remove(cachePath.c_str());
+		if(rename(tempPath.c_str(), cachePath.c_str()) != 0)
+			remove(tempPath.c_str());
+	}
 }
 
 void ThemeData::parseIncludes(const pugi::xml_node& root)
@@ -301,12 +893,15 @@ void ThemeData::parseIncludes(const pugi::xml_node& root)
 
 		mPaths.push_back(path);
 
-		pugi::xml_document includeDoc;
-		pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
-		if(!result)
-			throw error << "Error parsing file: \n    " << result.description();
+		std::string parseError;
+		std::shared_ptr<const pugi::xml_document> includeDoc = getDocument(path, parseError);
+		if(includeDoc == nullptr)
+			throw error << "Error parsing file: \n    " << parseError;
+
+		mFiles.push_back(path);
+		mDocuments.push_back(includeDoc);
 
-		pugi::xml_node theme = includeDoc.child("theme");
+		pugi::xml_node theme = includeDoc->child("theme");
 		if(!theme)
 			throw error << "Missing <theme> tag!";
 
@@ -437,6 +1032,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 		if(typeIt == typeMap.cend())
 			throw error << "Unknown property type \"" << node.name() << "\" (for element of type " << root.name() << ").";
 
+		const unsigned short propertyId = ThemeElement::getPropertyId(typeIt->first);
 		std::string str = resolvePlaceholders(node.text().as_string());
 
 		switch(typeIt->second)
@@ -457,7 +1053,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 					(float)atof(splits.at(2).c_str()), (float)atof(splits.at(3).c_str()));
 			}
 
-			element.properties[node.name()] = val / Vector4f(mResolution.x(), mResolution.y(), mResolution.x(), mResolution.y());
+			element.set(propertyId, val / Vector4f(mResolution.x(), mResolution.y(), mResolution.x(), mResolution.y()));
 			break;
 		}
 		case RESOLUTION_PAIR:
@@ -471,13 +1067,13 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 
 			Vector2f val((float)atof(first.c_str()), (float)atof(second.c_str()));
 
-			element.properties[node.name()] = val / mResolution;
+			element.set(propertyId, val / mResolution);
 			break;
 		}
 		case RESOLUTION_FLOAT:
 		{
 			float val = static_cast<float>(strtod(str.c_str(), 0));
-			element.properties[node.name()] = val / mResolution.y();
+			element.set(propertyId, val / mResolution.y());
 			break;
 		}
 		case NORMALIZED_RECT:
@@ -496,7 +1092,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 					(float)atof(splits.at(2).c_str()), (float)atof(splits.at(3).c_str()));
 			}
 
-			element.properties[node.name()] = val;
+			element.set(propertyId, val);
 			break;
 		}
 		case NORMALIZED_PAIR:
@@ -510,11 +1106,11 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 
 			Vector2f val((float)atof(first.c_str()), (float)atof(second.c_str()));
 
-			element.properties[node.name()] = val;
+			element.set(propertyId, val);
 			break;
 		}
 		case STRING:
-			element.properties[node.name()] = str;
+			element.set(propertyId, str);
 			break;
 		case PATH:
 		{
@@ -528,16 +1124,16 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 					ss << "(which resolved to \"" << path << "\") ";
 				LOG(LogWarning) << ss.str();
 			}
-			element.properties[node.name()] = path;
+			element.set(propertyId, path);
 			break;
 		}
 		case COLOR:
-			element.properties[node.name()] = getHexColor(str.c_str());
+			element.set(propertyId, getHexColor(str.c_str()));
 			break;
 		case FLOAT:
 		{
 			float floatVal = static_cast<float>(strtod(str.c_str(), 0));
-			element.properties[node.name()] = floatVal;
+			element.set(propertyId, floatVal);
 			break;
 		}
 
@@ -548,7 +1144,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 			// 1*, t* (true), T* (True), y* (yes), Y* (YES)
 			bool boolVal = (first == '1' || first == 't' || first == 'T' || first == 'y' || first == 'Y');
 
-			element.properties[node.name()] = boolVal;
+			element.set(propertyId, boolVal);
 			break;
 		}
 		default:
@@ -11,7 +11,7 @@
 #include <sstream>
 #include <vector>
 
-namespace pugi { class xml_node; }
+namespace pugi { class xml_document; class xml_node; }
 
 template<typename T>
 class TextListComponent;
@@ -47,6 +47,85 @@ namespace ThemeFlags
 	};
 }
 
+namespace ThemeProperty
+{
+	// Every property name an element type can have, interned so applyTheme can look properties up without
+	// hashing their names. Keep in the same order as the names in ThemeData.cpp.
+	enum Id : unsigned short
+	{
+		ALIGNMENT,
+		ANIMATE,
+		AUTO_LAYOUT,
+		AUTO_LAYOUT_SELECTED_ZOOM,
+		BACKGROUND_CENTER_COLOR,
+		BACKGROUND_COLOR,
+		BACKGROUND_CORNER_SIZE,
+		BACKGROUND_EDGE_COLOR,
+		BACKGROUND_IMAGE,
+		CENTER_SELECTION,
+		COLOR,
+		COLOR_END,
+		DEFAULT,
+		DELAY,
+		DISPLAY_RELATIVE,
+		FILLED_PATH,
+		FOLDER_IMAGE,
+		FONT_PATH,
+		FONT_SIZE,
+		FORCE_UPPERCASE,
+		FORMAT,
+		GAME_IMAGE,
+		GRADIENT_TYPE,
+		HORIZONTAL_MARGIN,
+		ICON_COLOR,
+		IMAGE_COLOR,
+		IMAGE_SOURCE,
+		LINE_SPACING,
+		LOGO_ALIGNMENT,
+		LOGO_ROTATION,
+		LOGO_ROTATION_ORIGIN,
+		LOGO_SCALE,
+		LOGO_SIZE,
+		MARGIN,
+		MAX_LOGO_COUNT,
+		MAX_SIZE,
+		MIN_LOGO_OPACITY,
+		MIN_SIZE,
+		ORIGIN,
+		PADDING,
+		PATH,
+		POS,
+		PRIMARY_COLOR,
+		ROTATION,
+		ROTATION_ORIGIN,
+		SCALED_LOGO_SPACING,
+		SCROLL_DIRECTION,
+		SCROLL_LOOP,
+		SCROLL_SOUND,
+		SECONDARY_COLOR,
+		SELECTED_COLOR,
+		SELECTOR_COLOR,
+		SELECTOR_COLOR_END,
+		SELECTOR_GRADIENT_TYPE,
+		SELECTOR_HEIGHT,
+		SELECTOR_IMAGE_PATH,
+		SELECTOR_IMAGE_TILE,
+		SELECTOR_OFFSET_Y,
+		SHOW_SNAPSHOT_DELAY,
+		SHOW_SNAPSHOT_NO_VIDEO,
+		SIZE,
+		TEXT,
+		TEXT_COLOR,
+		TILE,
+		TYPE,
+		UNFILLED_PATH,
+		VALUE,
+		VISIBLE,
+		Z_INDEX,
+		COUNT
+	};
+}
+
 class ThemeException : public std::exception
 {
 public:
@@ -93,38 +172,71 @@ public:
 		bool extra;
 		std::string type;
 
+		// Property names are interned to small ids when the theme is parsed and values are stored in a
+		// flat vector sorted by id, holding only the type the property was declared with in sElementMap.
 		struct Property
 		{
-			void operator= (const Vector4f& value)     { r = value; v = Vector2f(value.x(), value.y()); }
-			void operator= (const Vector2f& value)     { v = value; }
-			void operator= (const std::string& value)  { s = value; }
-			void operator= (const unsigned int& value) { i = value; }
-			void operator= (const float& value)        { f = value; }
-			void operator= (const bool& value)         { b = value; }
-
-			Vector4f     r;
-			Vector2f     v;
-			std::string  s;
-			unsigned int i;
-			float        f;
-			bool         b;
+			enum Type : unsigned char { RECT, PAIR, STRING, COLOR, FLOAT, BOOLEAN };
+
+			unsigned short id;
+			Type           type;
+			union
+			{
+				float        r[4]; // RECT, its first two values can also be read as a PAIR
+				float        v[2];
+				unsigned int i;    // COLOR, or the index in strings for STRING
+				float        f;
+				bool         b;
+			};
 		};
 
-		std::map< std::string, Property > properties;
+		std::vector<Property>    properties;
+		std::vector<std::string> strings;
+
+		// returns INVALID_PROPERTY if no element type has a property with this name, the id is a ThemeProperty::Id otherwise
+		static unsigned short getPropertyId(const std::string& name);
+		static const std::string& getPropertyName(unsigned short id);
+		static const unsigned short INVALID_PROPERTY = 0xFFFF;
 
+		void set(unsigned short id, const Vector4f& value);
+		void set(unsigned short id, const Vector2f& value);
+		void set(unsigned short id, const std::string& value);
+		void set(unsigned short id, const unsigned int& value);
+		void set(unsigned short id, const float& value);
+		void set(unsigned short id, const bool& value);
+
+		// throws std::out_of_range if the element doesn't have the property
 		template<typename T>
 		const T get(const std::string& prop) const
 		{
-			if(     std::is_same<T, Vector2f>::value)     return *(const T*)&properties.at(prop).v;
-			else if(std::is_same<T, std::string>::value)  return *(const T*)&properties.at(prop).s;
-			else if(std::is_same<T, unsigned int>::value) return *(const T*)&properties.at(prop).i;
-			else if(std::is_same<T, float>::value)        return *(const T*)&properties.at(prop).f;
-			else if(std::is_same<T, bool>::value)         return *(const T*)&properties.at(prop).b;
-			else if(std::is_same<T, Vector4f>::value)     return *(const T*)&properties.at(prop).r;
-			return T();
+			T value;
+			read(at(prop), value);
+			return value;
+		}
+
+		template<typename T>
+		const T get(ThemeProperty::Id prop) const
+		{
+			T value;
+			read(at(prop), value);
+			return value;
 		}
 
-		inline bool has(const std::string& prop) const { return (properties.find(prop) != properties.cend()); }
+		inline bool has(const std::string& prop) const { return (find(getPropertyId(prop)) != nullptr); }
+		inline bool has(ThemeProperty::Id prop) const { return (find(prop) != nullptr); }
+
+	private:
+		const Property* find(unsigned short id) const;
+		const Property& at(const std::string& prop) const;
+		const Property& at(ThemeProperty::Id prop) const;
+		Property& insert(unsigned short id, Property::Type type);
+
+		inline void read(const Property& p, Vector4f& out) const     { out = (p.type == Property::RECT) ? Vector4f(p.r[0], p.r[1], p.r[2], p.r[3]) : Vector4f::Zero(); }
+		inline void read(const Property& p, Vector2f& out) const     { out = (p.type == Property::PAIR || p.type == Property::RECT) ? Vector2f(p.v[0], p.v[1]) : Vector2f::Zero(); }
+		inline void read(const Property& p, std::string& out) const  { out = (p.type == Property::STRING) ? strings[p.i] : std::string(); }
+		inline void read(const Property& p, unsigned int& out) const { out = (p.type == Property::COLOR) ? p.i : 0; }
+		inline void read(const Property& p, float& out) const        { out = (p.type == Property::FLOAT) ? p.f : 0.0f; }
+		inline void read(const Property& p, bool& out) const         { out = (p.type == Property::BOOLEAN) ? p.b : false; }
 	};
 
 private:
@@ -165,6 +277,9 @@ public:
 
 	static const std::shared_ptr<ThemeData>& getDefault();
 
+	// Deletes the cache entries of themes whose files are gone, call once every theme was loaded
+	static void pruneCache();
+
 	static std::map<std::string, ThemeSet> getThemeSets();
 	static std::string getThemeFromCurrentSet(const std::string& system);
 
@@ -173,7 +288,20 @@ private:
 	static std::vector<std::string> sSupportedFeatures;
 	static std::vector<std::string> sSupportedViews;
 
+	// Parsed theme files are shared between every ThemeData that includes them and reparsed only when they change on disk.
+	// Returns nullptr and sets error_out if the file can't be parsed.
+	static std::shared_ptr<const pugi::xml_document> getDocument(const std::string& path, std::string& error_out);
+
+	// Fully resolved views are optionally saved to ~/.emulationstation/cache/themes so later loads of the
+	// same theme with the same system variables can skip parsing. Entries are checked against the size
+	// and modification time of every file that went into them.
+	static std::string getCachePath(const std::map<std::string, std::string>& sysDataMap, const std::string& path);
+	bool loadCache(const std::map<std::string, std::string>& sysDataMap, const std::string& path);
+	void saveCache(const std::map<std::string, std::string>& sysDataMap, const std::string& path) const;
+
 	std::deque<std::string> mPaths;
+	std::vector<std::string> mFiles; // every file this theme was parsed from, the root file first
+	std::vector< std::shared_ptr<const pugi::xml_document> > mDocuments; // keeps the files this theme used in the shared cache
 	float mVersion;
 	Vector2f mResolution;
 
@@ -3,6 +3,7 @@
 #include "components/HelpComponent.h"
 #include "components/ImageComponent.h"
 #include "resources/Font.h"
+#include "resources/TexturePrefetcher.h"
 #include "resources/TextureResource.h"
 #include "Log.h"
 #include "Scripting.h"
@@ -13,7 +14,15 @@
 #include <SDL_events.h>
 #endif
 
-Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10),
+// longest an idle main loop sleeps before updating again, keeps polling components responsive
+#define IDLE_TIMEOUT_MAX_MS 100
+// while textures load in the background, check back often so they show up as soon as they're ready
+#define IDLE_TIMEOUT_LOADING_MS 10
+// how often the framerate overlay is refreshed
+#define FRAMERATE_UPDATE_MS 500
+
+Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mIdleTimeElapsed(0), mIdleCountElapsed(0), mAverageDeltaTime(10),
+	mFrameDirty(true), mIdle(false), mWasAnimating(false), mTextureLoadedCount(0),
 	mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mScreenSaver(NULL), mRenderScreenSaver(false), mInfoPopup(NULL)
 {
 	mHelp = new HelpComponent(this);
@@ -40,6 +49,7 @@ void Window::pushGui(GuiComponent* gui)
 	}
 	mGuiStack.push_back(gui);
 	gui->updateHelpPrompts();
+	mFrameDirty = true;
 }
 
 void Window::removeGui(GuiComponent* gui)
@@ -49,6 +59,7 @@ void Window::removeGui(GuiComponent* gui)
 		if(*i == gui)
 		{
 			i = mGuiStack.erase(i);
+			mFrameDirty = true;
 
 			if(i == mGuiStack.cend() && mGuiStack.size()) // we just popped the stack and the stack is not empty
 			{
@@ -94,6 +105,7 @@ bool Window::init()
 	if(peekGui())
 		peekGui()->updateHelpPrompts();
 
+	mFrameDirty = true;
 	return true;
 }
 
@@ -110,12 +122,15 @@ void Window::deinit()
 
 void Window::textInput(const char* text)
 {
+	mFrameDirty = true;
 	if(peekGui())
 		peekGui()->textInput(text);
 }
 
 void Window::input(InputConfig* config, Input input)
 {
+	mFrameDirty = true;
+
 	if (mScreenSaver && mScreenSaver->isScreenSaverActive() && Settings::getInstance()->getBool("ScreenSaverControls")
 		&& mScreenSaver->inputDuringScreensaver(config, input))
 	{
@@ -168,17 +183,36 @@ void Window::update(int deltaTime)
 
 	mFrameTimeElapsed += deltaTime;
 	mFrameCountElapsed++;
-	if(mFrameTimeElapsed > 500)
+
+	// the time since a skipped frame was spent waiting
+	if(mIdle)
 	{
-		mAverageDeltaTime = mFrameTimeElapsed / mFrameCountElapsed;
+		mIdleTimeElapsed += deltaTime;
+		mIdleCountElapsed++;
+	}
+
+	if(mFrameTimeElapsed > FRAMERATE_UPDATE_MS)
+	{
+		const int renderTimeElapsed = mFrameTimeElapsed - mIdleTimeElapsed;
+		const int renderCountElapsed = mFrameCountElapsed - mIdleCountElapsed;
+
+		if(renderCountElapsed > 0)
+			mAverageDeltaTime = renderTimeElapsed / renderCountElapsed;
+
+		unsigned int bindsRequested;
+		unsigned int bindsDone;
+		Renderer::getTextureBinds(bindsRequested, bindsDone);
 
 		if(Settings::getInstance()->getBool("DrawFramerate"))
 		{
 			std::stringstream ss;
 
-			// fps
-			ss << std::fixed << std::setprecision(1) << (1000.0f * (float)mFrameCountElapsed / (float)mFrameTimeElapsed) << "fps, ";
-			ss << std::fixed << std::setprecision(2) << ((float)mFrameTimeElapsed / (float)mFrameCountElapsed) << "ms";
+			// fps, only counting frames that were actually drawn
+			ss << std::fixed << std::setprecision(1) << (1000.0f * (float)renderCountElapsed / (float)mFrameTimeElapsed) << "fps, ";
+			ss << std::fixed << std::setprecision(2) << (renderCountElapsed > 0 ? ((float)renderTimeElapsed / (float)renderCountElapsed) : 0.0f) << "ms, ";
+
+			// share of the time spent waiting instead of drawing
+			ss << std::fixed << std::setprecision(1) << (100.0f * (float)mIdleTimeElapsed / (float)mFrameTimeElapsed) << "% idle";
 
 			// vram
 			float textureVramUsageMb = TextureResource::getTotalMemUsage() / 1000.0f / 1000.0f;
@@ -187,21 +221,62 @@ void Window::update(int deltaTime)
 
 			ss << "\nFont VRAM: " << fontVramUsageMb << " Tex VRAM: " << textureVramUsageMb <<
 				  " Tex Max: " << textureTotalUsageMb;
+
+			// textures unloaded to stay within MaxVRAM and MaxTextureRAM
+			ss << "\nTex RAM: " << (TextureResource::getTotalRAMUsage() / 1000.0f / 1000.0f) << " Evicted: " << TextureResource::getEvictedCount() <<
+				  " (" << (TextureResource::getEvictedSize() / 1000.0f / 1000.0f) << ")";
+
+			// texture binds per frame, the ones skipped because the texture was already bound are saved
+			if(renderCountElapsed > 0)
+			{
+				ss << "\nTex binds: " << (bindsDone / renderCountElapsed) << " Skipped: " <<
+					  ((bindsRequested - bindsDone) / renderCountElapsed);
+			}
+
+			// textures decoded ahead of time, and what waits to be used
+			const TexturePrefetcher::Stats prefetch = TexturePrefetcher::getInstance().getStats();
+			ss << "\nPrefetch hits: " << prefetch.hits << " Late: " << prefetch.late << " Wasted: " << prefetch.wasted <<
+				  " Held: " << std::setprecision(2) << (prefetch.bytes / 1000.0f / 1000.0f);
 			mFrameDataText = std::unique_ptr<TextCache>(mDefaultFonts.at(1)->buildTextCache(ss.str(), 50.f, 50.f, 0xFF00FFFF));
+			mFrameDirty = true;
 		}
 
 		mFrameTimeElapsed = 0;
 		mFrameCountElapsed = 0;
+		mIdleTimeElapsed = 0;
+		mIdleCountElapsed = 0;
 	}
 
 	mTimeSinceLastInput += deltaTime;
 
+	// woken up from idle by input, don't let any animation it starts jump ahead by the time we waited
+	if(mIdle && mFrameDirty && deltaTime > mAverageDeltaTime)
+		deltaTime = mAverageDeltaTime;
+
 	if(peekGui())
 		peekGui()->update(deltaTime);
 
 	// Update the screensaver
 	if (mScreenSaver)
 		mScreenSaver->update(deltaTime);
+
+	unsigned int screensaverTime = (unsigned int)Settings::getInstance()->getInt("ScreenSaverTime");
+	if(mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
+	{
+		startScreenSaver();
+
+		unsigned int systemSleepTime = (unsigned int)Settings::getInstance()->getInt("SystemSleepTime");
+		if(!isProcessing() && mAllowSleep && systemSleepTime != 0 && mTimeSinceLastInput >= systemSleepTime) {
+			mSleeping = true;
+			onSleep();
+		}
+	}
+
+	// nothing to draw next frame if nothing changed and nothing is moving on its own, the frame an
+	// animation ended on still has to be drawn
+	const bool animating = isAnimating();
+	mIdle = !mFrameDirty && Settings::getInstance()->getBool("SkipIdleFrames") && !animating && !mWasAnimating;
+	mWasAnimating = animating;
 }
 
 void Window::render()
@@ -233,10 +308,6 @@ void Window::render()
 		mDefaultFonts.at(1)->renderTextCache(mFrameDataText.get());
 	}
 
-	unsigned int screensaverTime = (unsigned int)Settings::getInstance()->getInt("ScreenSaverTime");
-	if(mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
-		startScreenSaver();
-
 	// Always call the screensaver render function regardless of whether the screensaver is active
 	// or not because it may perform a fade on transition
 	renderScreenSaver();
@@ -246,14 +317,29 @@ void Window::render()
 		mInfoPopup->render(transform);
 	}
 
-	if(mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
-	{
-		unsigned int systemSleepTime = (unsigned int)Settings::getInstance()->getInt("SystemSleepTime");
-		if(!isProcessing() && mAllowSleep && systemSleepTime != 0 && mTimeSinceLastInput >= systemSleepTime) {
-			mSleeping = true;
-			onSleep();
-		}
-	}
+	mFrameDirty = false;
+}
+
+int Window::getIdleTimeout()
+{
+	int timeout = IDLE_TIMEOUT_MAX_MS;
+
+	// wake up in time to start the screensaver or go to sleep
+	unsigned int screensaverTime = (unsigned int)Settings::getInstance()->getInt("ScreenSaverTime");
+	if(screensaverTime != 0 && mTimeSinceLastInput < screensaverTime)
+		timeout = std::min(timeout, (int)(screensaverTime - mTimeSinceLastInput));
+
+	unsigned int systemSleepTime = (unsigned int)Settings::getInstance()->getInt("SystemSleepTime");
+	if(systemSleepTime != 0 && mTimeSinceLastInput < systemSleepTime)
+		timeout = std::min(timeout, (int)(systemSleepTime - mTimeSinceLastInput));
+
+	if(Settings::getInstance()->getBool("DrawFramerate"))
+		timeout = std::min(timeout, FRAMERATE_UPDATE_MS - mFrameTimeElapsed);
+
+	if(TextureResource::isLoading())
+		timeout = std::min(timeout, IDLE_TIMEOUT_LOADING_MS);
+
+	return std::max(timeout, 1);
 }
 
 void Window::normalizeNextUpdate()
@@ -324,6 +410,7 @@ void Window::renderHelpPromptsEarly()
 
 void Window::setHelpPrompts(const std::vector<HelpPrompt>& prompts, const HelpStyle& style)
 {
+	mFrameDirty = true;
 	mHelp->clearPrompts();
 	mHelp->setStyle(style);
 
@@ -418,6 +505,35 @@ bool Window::isProcessing()
 	return count_if(mGuiStack.cbegin(), mGuiStack.cend(), [](GuiComponent* c) { return c->isProcessing(); }) > 0;
 }
 
+bool Window::isAnimating()
+{
+	// a texture finished loading in the background and needs to be uploaded and drawn
+	const unsigned int textureLoadedCount = TextureResource::getLoadedCount();
+	if(textureLoadedCount != mTextureLoadedCount)
+	{
+		mTextureLoadedCount = textureLoadedCount;
+		return true;
+	}
+
+	if(mRenderScreenSaver || (mScreenSaver && mScreenSaver->isScreenSaverActive()))
+		return true;
+
+	if(mInfoPopup && mInfoPopup->isRunning())
+		return true;
+
+	if(isProcessing())
+		return true;
+
+	// only the bottom and top of the stack are drawn
+	if(mGuiStack.size())
+	{
+		if(mGuiStack.front()->isAnimating() || mGuiStack.back()->isAnimating())
+			return true;
+	}
+
+	return false;
+}
+
 void Window::startScreenSaver(SystemData* system)
 {
 	if (mScreenSaver && !mRenderScreenSaver)
@@ -429,6 +545,7 @@ void Window::startScreenSaver(SystemData* system)
 
 		mScreenSaver->startScreenSaver(system);
 		mRenderScreenSaver = true;
+		mFrameDirty = true;
 	}
 }
 
@@ -438,6 +555,7 @@ bool Window::cancelScreenSaver()
 	{
 		mScreenSaver->stopScreenSaver();
 		mRenderScreenSaver = false;
+		mFrameDirty = true;
 		Scripting::fireEvent("screensaver-stop");
 
 		// Tell the GUI components the screensaver has stopped
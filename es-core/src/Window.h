@@ -39,6 +39,7 @@ public:
 	public:
 		virtual void render(const Transform4x4f& parentTrans) = 0;
 		virtual void stop() = 0;
+		virtual bool isRunning() = 0;
 		virtual ~InfoPopup() {};
 	};
 
@@ -60,6 +61,13 @@ public:
 
 	void normalizeNextUpdate();
 
+	// Forces the next frame to be drawn, for changes that happen outside of input and animations
+	inline void invalidate() { mFrameDirty = true; }
+	// Returns true if nothing on screen changed since the last frame, so drawing it can be skipped
+	inline bool isIdle() const { return mIdle; }
+	// Returns how long (in ms) an idle main loop can wait for input before the next timer runs out
+	int getIdleTimeout();
+
 	inline bool isSleeping() const { return mSleeping; }
 	bool getAllowSleep();
 	void setAllowSleep(bool sleep);
@@ -84,6 +92,9 @@ private:
 	// Returns true if at least one component on the stack is processing
 	bool isProcessing();
 
+	// Returns true if anything on screen will change on its own (animations, videos, screensaver, texture loads)
+	bool isAnimating();
+
 	HelpComponent*	mHelp;
 	ImageComponent* mBackgroundOverlay;
 	ScreenSaver*	mScreenSaver;
@@ -96,12 +107,19 @@ private:
 
 	int mFrameTimeElapsed;
 	int mFrameCountElapsed;
+	int mIdleTimeElapsed;
+	int mIdleCountElapsed;
 	int mAverageDeltaTime;
 
 	std::unique_ptr<TextCache> mFrameDataText;
 
 	bool mNormalizeNextUpdate;
 
+	bool mFrameDirty;
+	bool mIdle;
+	bool mWasAnimating;
+	unsigned int mTextureLoadedCount;
+
 	bool mAllowSleep;
 	bool mSleeping;
 	unsigned int mTimeSinceLastInput;
@@ -50,6 +50,11 @@ void AnimatedImageComponent::onSizeChanged()
 	}
 }
 
+bool AnimatedImageComponent::isAnimating() const
+{
+	return mEnabled && mFrames.size() > 1;
+}
+
 void AnimatedImageComponent::update(int deltaTime)
 {
 	if(!mEnabled || mFrames.size() == 0)
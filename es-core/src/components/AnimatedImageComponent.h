@@ -30,6 +30,7 @@ public:
 
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& trans) override;
+	bool isAnimating() const override;
 
 	void onSizeChanged() override;
 
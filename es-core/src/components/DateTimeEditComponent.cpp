@@ -3,6 +3,7 @@
 #include "DateTimeComponent.h"
 #include "resources/Font.h"
 #include "utils/StringUtil.h"
+#include "Window.h"
 
 DateTimeEditComponent::DateTimeEditComponent(Window* window, DisplayMode dispMode) : GuiComponent(window),
 	mEditing(false), mEditIndex(0), mDisplayMode(dispMode), mRelativeUpdateAccumulator(0),
@@ -132,6 +133,7 @@ void DateTimeEditComponent::update(int deltaTime)
 		{
 			mRelativeUpdateAccumulator = 0;
 			updateTextCache();
+			mWindow->invalidate();
 		}
 	}
 
@@ -318,17 +320,17 @@ void DateTimeEditComponent::applyTheme(const std::shared_ptr<ThemeData>& theme,
 	// setSize(), which will call updateTextCache(), which will reset mSize if
 	// mAutoSize == true, ignoring the theme's value.
 	if(properties & ThemeFlags::SIZE)
-		mAutoSize = !elem->has("size");
+		mAutoSize = !elem->has(ThemeProperty::SIZE);
 
 	GuiComponent::applyTheme(theme, view, element, properties);
 
 	using namespace ThemeFlags;
 
-	if(properties & COLOR && elem->has("color"))
-		setColor(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColor(elem->get<unsigned int>(ThemeProperty::COLOR));
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 }
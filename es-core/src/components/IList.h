@@ -107,6 +107,12 @@ public:
 		return mScrollVelocity;
 	}
 
+	bool isAnimating() const override
+	{
+		// held direction keys scroll on their own and the title overlay fades in and out
+		return (mScrollVelocity != 0 || mTitleOverlayOpacity != 0 || GuiComponent::isAnimating());
+	}
+
 	void stopScrolling(bool focusLost = false)
 	{
 		if (focusLost) {
@@ -139,6 +145,13 @@ public:
 		return mEntries.at(mCursor).object;
 	}
 
+	inline int getCursorIndex() const { return mCursor; }
+
+	inline const UserData& getObjectAt(int index) const
+	{
+		return mEntries.at(index).object;
+	}
+
 	void setCursor(typename std::vector<Entry>::const_iterator& it)
 	{
 		assert(it != mEntries.cend());
@@ -1,6 +1,7 @@
 #include "components/ImageComponent.h"
 
 #include "resources/TextureResource.h"
+#include "utils/StringUtil.h"
 #include "Log.h"
 #include "Settings.h"
 #include "ThemeData.h"
@@ -19,9 +20,9 @@ Vector2f ImageComponent::getSize() const
 }
 
 ImageComponent::ImageComponent(Window* window, bool forceLoad, bool dynamic) : GuiComponent(window),
-	mTargetIsMax(false), mTargetIsMin(false), mFlipX(false), mFlipY(false), mTargetSize(0, 0), mColorShift(0xFFFFFFFF),
+	mTargetIsMax(false), mTargetIsMin(false), mFlipX(false), mFlipY(false), mTargetSize(0, 0), mTextureMaxSize(0, 0), mColorShift(0xFFFFFFFF),
 	mColorShiftEnd(0xFFFFFFFF), mColorGradientHorizontal(true), mForceLoad(forceLoad), mDynamic(dynamic),
-	mFadeOpacity(0), mFading(false), mRotateByTargetSize(false), mTopLeftCrop(0.0f, 0.0f), mBottomRightCrop(1.0f, 1.0f)
+	mFadeOpacity(0), mFading(false), mRotateByTargetSize(false), mTopLeftCrop(0.0f, 0.0f), mBottomRightCrop(1.0f, 1.0f), mTextureTile(false)
 {
 	updateColors();
 }
@@ -120,6 +121,64 @@ void ImageComponent::resize()
 	onSizeChanged();
 }
 
+// rounds up to a power of two so images shown at similar sizes share the same decoded texture
+static int roundTextureSize(float size)
+{
+	const int target = (int)Math::ceilf(size);
+	int rounded = 1;
+	while(rounded < target)
+		rounded <<= 1;
+	return rounded;
+}
+
+Vector2i ImageComponent::getTextureMaxSize(const std::string& path, bool tile) const
+{
+	// cropped, tiled and scalable images need all of their pixels
+	if(mTargetIsMin || tile || mTargetSize == Vector2f::Zero())
+		return Vector2i::Zero();
+
+	if(path.size() >= 4 && Utils::String::toLower(path.substr(path.size() - 4, std::string::npos)) == ".svg")
+		return Vector2i::Zero();
+
+	const Vector2f& size = (mTextureMaxSize != Vector2f::Zero()) ? mTextureMaxSize : mTargetSize;
+	return Vector2i(size.x() > 0 ? roundTextureSize(size.x()) : 0, size.y() > 0 ? roundTextureSize(size.y()) : 0);
+}
+
+void ImageComponent::setTextureMaxSize(const Vector2f& size)
+{
+	if(size == mTextureMaxSize)
+		return;
+
+	mTextureMaxSize = size;
+	updateTextureMaxSize();
+	resize();
+}
+
+void ImageComponent::updateTextureMaxSize()
+{
+	if(!mTexture || mTexturePath.empty())
+		return;
+
+	const Vector2i maxSize = getTextureMaxSize(mTexturePath, mTextureTile);
+	if(maxSize != mTexture->getMaxSize())
+		mTexture = TextureResource::get(mTexturePath, mTextureTile, mForceLoad, mDynamic, maxSize);
+}
+
+TexturePrefetcher::Request ImageComponent::getPrefetchRequest(const std::string& path) const
+{
+	TexturePrefetcher::Request request;
+	request.tile = false;
+
+	// only textures managed by the TextureDataManager can take prefetched data
+	if(mDynamic)
+	{
+		request.path = path;
+		request.maxSize = getTextureMaxSize(path, false);
+	}
+
+	return request;
+}
+
 void ImageComponent::onSizeChanged()
 {
 	updateVertices();
@@ -132,14 +191,23 @@ void ImageComponent::setDefaultImage(std::string path)
 
 void ImageComponent::setImage(std::string path, bool tile)
 {
+	mTextureTile = tile;
+
 	if(path.empty() || !ResourceManager::getInstance()->fileExists(path))
 	{
 		if(mDefaultPath.empty() || !ResourceManager::getInstance()->fileExists(mDefaultPath))
+		{
+			mTexturePath.clear();
 			mTexture.reset();
+		}
 		else
-			mTexture = TextureResource::get(mDefaultPath, tile, mForceLoad, mDynamic);
+		{
+			mTexturePath = mDefaultPath;
+			mTexture = TextureResource::get(mDefaultPath, tile, mForceLoad, mDynamic, getTextureMaxSize(mTexturePath, mTextureTile));
+		}
 	} else {
-		mTexture = TextureResource::get(path, tile, mForceLoad, mDynamic);
+		mTexturePath = path;
+		mTexture = TextureResource::get(path, tile, mForceLoad, mDynamic, getTextureMaxSize(mTexturePath, mTextureTile));
 	}
 
 	resize();
@@ -148,6 +216,7 @@ void ImageComponent::setImage(std::string path, bool tile)
 void ImageComponent::setImage(const char* path, size_t length, bool tile)
 {
 	mTexture.reset();
+	mTexturePath.clear();
 
 	mTexture = TextureResource::get("", tile);
 	mTexture->initFromMemory(path, length);
@@ -158,6 +227,7 @@ void ImageComponent::setImage(const char* path, size_t length, bool tile)
 void ImageComponent::setImage(const std::shared_ptr<TextureResource>& texture)
 {
 	mTexture = texture;
+	mTexturePath.clear();
 	resize();
 }
 
@@ -166,6 +236,7 @@ void ImageComponent::setResize(float width, float height)
 	mTargetSize = Vector2f(width, height);
 	mTargetIsMax = false;
 	mTargetIsMin = false;
+	updateTextureMaxSize();
 	resize();
 }
 
@@ -174,6 +245,7 @@ void ImageComponent::setMaxSize(float width, float height)
 	mTargetSize = Vector2f(width, height);
 	mTargetIsMax = true;
 	mTargetIsMin = false;
+	updateTextureMaxSize();
 	resize();
 }
 
@@ -182,6 +254,7 @@ void ImageComponent::setMinSize(float width, float height)
 	mTargetSize = Vector2f(width, height);
 	mTargetIsMax = false;
 	mTargetIsMin = true;
+	updateTextureMaxSize();
 	resize();
 }
 
@@ -339,7 +412,10 @@ void ImageComponent::render(const Transform4x4f& parentTrans)
 			// texture is bound in this case but we want to handle a fade so it doesn't just 'jump' in
 			// when it finally loads
 			fadeIn(mTexture->bind());
-			Renderer::drawTriangleStrips(&mVertices[0], 4);
+
+			// images packed into an atlas page need their texture coordinates moved to their part of the page
+			Renderer::Vertex atlasVertices[4];
+			Renderer::drawTriangleStrips(mTexture->mapTextureCoords(&mVertices[0], atlasVertices, 4) ? atlasVertices : &mVertices[0], 4);
 
 		}else{
 			LOG(LogError) << "Image texture is not initialized!";
@@ -350,6 +426,12 @@ void ImageComponent::render(const Transform4x4f& parentTrans)
 	GuiComponent::renderChildren(trans);
 }
 
+bool ImageComponent::isAnimating() const
+{
+	// still waiting for the texture is not animating, the window wakes up once a background load completes
+	return (mFading && mFadeOpacity > 0) || GuiComponent::isAnimating();
+}
+
 void ImageComponent::fadeIn(bool textureLoaded)
 {
 	if (!mForceLoad)
@@ -405,33 +487,33 @@ void ImageComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const s
 
 	if(properties & ThemeFlags::SIZE)
 	{
-		if(elem->has("size"))
-			setResize(elem->get<Vector2f>("size") * scale);
-		else if(elem->has("maxSize"))
-			setMaxSize(elem->get<Vector2f>("maxSize") * scale);
-		else if(elem->has("minSize"))
-			setMinSize(elem->get<Vector2f>("minSize") * scale);
+		if(elem->has(ThemeProperty::SIZE))
+			setResize(elem->get<Vector2f>(ThemeProperty::SIZE) * scale);
+		else if(elem->has(ThemeProperty::MAX_SIZE))
+			setMaxSize(elem->get<Vector2f>(ThemeProperty::MAX_SIZE) * scale);
+		else if(elem->has(ThemeProperty::MIN_SIZE))
+			setMinSize(elem->get<Vector2f>(ThemeProperty::MIN_SIZE) * scale);
 	}
 
-	if(elem->has("default"))
-		setDefaultImage(elem->get<std::string>("default"));
+	if(elem->has(ThemeProperty::DEFAULT))
+		setDefaultImage(elem->get<std::string>(ThemeProperty::DEFAULT));
 
-	if(properties & PATH && elem->has("path"))
+	if(properties & PATH && elem->has(ThemeProperty::PATH))
 	{
-		bool tile = (elem->has("tile") && elem->get<bool>("tile"));
-		setImage(elem->get<std::string>("path"), tile);
+		bool tile = (elem->has(ThemeProperty::TILE) && elem->get<bool>(ThemeProperty::TILE));
+		setImage(elem->get<std::string>(ThemeProperty::PATH), tile);
 	}
 
 	if(properties & COLOR)
 	{
-		if(elem->has("color"))
-			setColorShift(elem->get<unsigned int>("color"));
+		if(elem->has(ThemeProperty::COLOR))
+			setColorShift(elem->get<unsigned int>(ThemeProperty::COLOR));
 
-		if (elem->has("colorEnd"))
-			setColorShiftEnd(elem->get<unsigned int>("colorEnd"));
+		if (elem->has(ThemeProperty::COLOR_END))
+			setColorShiftEnd(elem->get<unsigned int>(ThemeProperty::COLOR_END));
 
-		if (elem->has("gradientType"))
-			setColorGradientHorizontal(!(elem->get<std::string>("gradientType").compare("horizontal")));
+		if (elem->has(ThemeProperty::GRADIENT_TYPE))
+			setColorGradientHorizontal(!(elem->get<std::string>(ThemeProperty::GRADIENT_TYPE).compare("horizontal")));
 	}
 }
 
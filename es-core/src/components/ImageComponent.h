@@ -3,6 +3,7 @@
 #define ES_CORE_COMPONENTS_IMAGE_COMPONENT_H
 
 #include "renderers/Renderer.h"
+#include "resources/TexturePrefetcher.h"
 #include "math/Vector2i.h"
 #include "GuiComponent.h"
 
@@ -42,6 +43,10 @@ public:
 	void setMinSize(float width, float height);
 	inline void setMinSize(const Vector2f& size) { setMinSize(size.x(), size.y()); }
 
+	// Decode the texture to cover this size rather than the target size, for images whose size is animated
+	// so the texture isn't reloaded on every step. (0, 0) goes back to the target size.
+	void setTextureMaxSize(const Vector2f& size);
+
 	Vector2f getRotationSize() const override;
 
 	// Applied AFTER image positioning and sizing
@@ -72,13 +77,20 @@ public:
 
 	void render(const Transform4x4f& parentTrans) override;
 
+	// the fade in after a texture loads advances as it is drawn
+	bool isAnimating() const override;
+
 	virtual void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
 
 	std::shared_ptr<TextureResource> getTexture() { return mTexture; };
+
+	// What setImage(path) would load at the current size, to decode it ahead of time. The path is empty if it can't be prefetched.
+	TexturePrefetcher::Request getPrefetchRequest(const std::string& path) const;
 private:
 	Vector2f mTargetSize;
+	Vector2f mTextureMaxSize;
 
 	bool mFlipX, mFlipY, mTargetIsMax, mTargetIsMin;
 
@@ -86,6 +98,11 @@ private:
 	// Used internally whenever the resizing parameters or texture change.
 	void resize();
 
+	// Size the texture has to cover to be drawn at full quality, or (0, 0) if it has to be decoded at its own size.
+	Vector2i getTextureMaxSize(const std::string& path, bool tile) const;
+	// Reloads the texture from mTexturePath when the resizing parameters ask for a different decode size.
+	void updateTextureMaxSize();
+
 	Renderer::Vertex mVertices[4];
 
 	void updateVertices();
@@ -97,6 +114,8 @@ private:
 	bool mColorGradientHorizontal;
 
 	std::string mDefaultPath;
+	std::string mTexturePath;
+	bool mTextureTile;
 
 	std::shared_ptr<TextureResource> mTexture;
 	unsigned char			mFadeOpacity;
@@ -55,6 +55,7 @@ public:
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Transform4x4f& parentTrans) override;
+	bool isAnimating() const override;
 	virtual void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	void onSizeChanged() override;
@@ -195,6 +196,22 @@ void ImageGridComponent<T>::update(int deltaTime)
 		(*it)->update(deltaTime);
 }
 
+template<typename T>
+bool ImageGridComponent<T>::isAnimating() const
+{
+	if(IList<ImageGridData, T>::isAnimating())
+		return true;
+
+	// tiles aren't children, check their zoom animations ourselves
+	for(auto it = mTiles.cbegin(); it != mTiles.cend(); it++)
+	{
+		if((*it)->isAnimating())
+			return true;
+	}
+
+	return false;
+}
+
 template<typename T>
 void ImageGridComponent<T>::render(const Transform4x4f& parentTrans)
 {
@@ -259,21 +276,21 @@ void ImageGridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "imagegrid");
 	if (elem)
 	{
-		if (elem->has("margin"))
-			mMargin = elem->get<Vector2f>("margin") * screen;
+		if (elem->has(ThemeProperty::MARGIN))
+			mMargin = elem->get<Vector2f>(ThemeProperty::MARGIN) * screen;
 
-		if (elem->has("padding"))
-			mPadding = elem->get<Vector4f>("padding") * Vector4f(screen.x(), screen.y(), screen.x(), screen.y());
+		if (elem->has(ThemeProperty::PADDING))
+			mPadding = elem->get<Vector4f>(ThemeProperty::PADDING) * Vector4f(screen.x(), screen.y(), screen.x(), screen.y());
 
-		if (elem->has("autoLayout"))
-			mAutoLayout = elem->get<Vector2f>("autoLayout");
+		if (elem->has(ThemeProperty::AUTO_LAYOUT))
+			mAutoLayout = elem->get<Vector2f>(ThemeProperty::AUTO_LAYOUT);
 
-		if (elem->has("autoLayoutSelectedZoom"))
-			mAutoLayoutZoom = elem->get<float>("autoLayoutSelectedZoom");
+		if (elem->has(ThemeProperty::AUTO_LAYOUT_SELECTED_ZOOM))
+			mAutoLayoutZoom = elem->get<float>(ThemeProperty::AUTO_LAYOUT_SELECTED_ZOOM);
 
-		if (elem->has("imageSource"))
+		if (elem->has(ThemeProperty::IMAGE_SOURCE))
 		{
-			auto direction = elem->get<std::string>("imageSource");
+			auto direction = elem->get<std::string>(ThemeProperty::IMAGE_SOURCE);
 			if (direction == "image")
 				mImageSource = IMAGE;
 			else if (direction == "marquee")
@@ -284,25 +301,25 @@ void ImageGridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 		else
 			mImageSource = THUMBNAIL;
 
-		if (elem->has("scrollDirection"))
-			mScrollDirection = (ScrollDirection)(elem->get<std::string>("scrollDirection") == "horizontal");
+		if (elem->has(ThemeProperty::SCROLL_DIRECTION))
+			mScrollDirection = (ScrollDirection)(elem->get<std::string>(ThemeProperty::SCROLL_DIRECTION) == "horizontal");
 
-		if (elem->has("centerSelection"))
+		if (elem->has(ThemeProperty::CENTER_SELECTION))
 		{
-			mCenterSelection = (elem->get<bool>("centerSelection"));
+			mCenterSelection = (elem->get<bool>(ThemeProperty::CENTER_SELECTION));
 
-			if (elem->has("scrollLoop"))
-				mScrollLoop = (elem->get<bool>("scrollLoop"));
+			if (elem->has(ThemeProperty::SCROLL_LOOP))
+				mScrollLoop = (elem->get<bool>(ThemeProperty::SCROLL_LOOP));
 		}
 
-		if (elem->has("animate"))
-			mAnimate = (elem->get<bool>("animate"));
+		if (elem->has(ThemeProperty::ANIMATE))
+			mAnimate = (elem->get<bool>(ThemeProperty::ANIMATE));
 		else
 			mAnimate = true;
 
-		if (elem->has("gameImage"))
+		if (elem->has(ThemeProperty::GAME_IMAGE))
 		{
-			std::string path = elem->get<std::string>("gameImage");
+			std::string path = elem->get<std::string>(ThemeProperty::GAME_IMAGE);
 
 			if (!ResourceManager::getInstance()->fileExists(path))
 			{
@@ -323,9 +340,9 @@ void ImageGridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 			}
 		}
 
-		if (elem->has("folderImage"))
+		if (elem->has(ThemeProperty::FOLDER_IMAGE))
 		{
-			std::string path = elem->get<std::string>("folderImage");
+			std::string path = elem->get<std::string>(ThemeProperty::FOLDER_IMAGE);
 
 			if (!ResourceManager::getInstance()->fileExists(path))
 			{
@@ -351,8 +368,8 @@ void ImageGridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme,
 	// so we can recalculate the new grid dimension, and THEN (re)build the tiles
 	elem = theme->getElement(view, "default", "gridtile");
 
-	mTileSize = elem && elem->has("size") ?
-				elem->get<Vector2f>("size") * screen :
+	mTileSize = elem && elem->has(ThemeProperty::SIZE) ?
+				elem->get<Vector2f>(ThemeProperty::SIZE) * screen :
 				GridTileComponent::getDefaultTileSize();
 
 	// Apply size property, will trigger a call to onSizeChanged() which will build the tiles
@@ -102,7 +102,9 @@ void NinePatchComponent::render(const Transform4x4f& parentTrans)
 		Renderer::setMatrix(trans);
 
 		mTexture->bind();
-		Renderer::drawTriangleStrips(&mVertices[0], 6*9);
+
+		Renderer::Vertex atlasVertices[6*9];
+		Renderer::drawTriangleStrips(mTexture->mapTextureCoords(&mVertices[0], atlasVertices, 6*9) ? atlasVertices : &mVertices[0], 6*9);
 	}
 
 	renderChildren(trans);
@@ -163,6 +165,6 @@ void NinePatchComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, con
 	if(!elem)
 		return;
 
-	if(properties & PATH && elem->has("path"))
-		setImagePath(elem->get<std::string>("path"));
+	if(properties & PATH && elem->has(ThemeProperty::PATH))
+		setImagePath(elem->get<std::string>(ThemeProperty::PATH));
 }
@@ -110,8 +110,17 @@ void ScrollableContainer::update(int deltaTime)
 	GuiComponent::update(deltaTime);
 }
 
+bool ScrollableContainer::isAnimating() const
+{
+	// only autoscrolling content that doesn't fit moves on its own
+	if(mAutoScrollSpeed != 0 && getContentSize().y() > getSize().y())
+		return true;
+
+	return GuiComponent::isAnimating();
+}
+
 //this should probably return a box to allow for when controls don't start at 0,0
-Vector2f ScrollableContainer::getContentSize()
+Vector2f ScrollableContainer::getContentSize() const
 {
 	Vector2f max(0, 0);
 	for(unsigned int i = 0; i < mChildren.size(); i++)
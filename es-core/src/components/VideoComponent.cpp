@@ -190,23 +190,23 @@ void VideoComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const s
 
 	if(properties & ThemeFlags::SIZE)
 	{
-		if(elem->has("size"))
-			setResize(elem->get<Vector2f>("size") * scale);
-		else if(elem->has("maxSize"))
-			setMaxSize(elem->get<Vector2f>("maxSize") * scale);
+		if(elem->has(ThemeProperty::SIZE))
+			setResize(elem->get<Vector2f>(ThemeProperty::SIZE) * scale);
+		else if(elem->has(ThemeProperty::MAX_SIZE))
+			setMaxSize(elem->get<Vector2f>(ThemeProperty::MAX_SIZE) * scale);
 	}
 
-	if(elem->has("default"))
-		mConfig.defaultVideoPath = elem->get<std::string>("default");
+	if(elem->has(ThemeProperty::DEFAULT))
+		mConfig.defaultVideoPath = elem->get<std::string>(ThemeProperty::DEFAULT);
 
-	if((properties & ThemeFlags::DELAY) && elem->has("delay"))
-		mConfig.startDelay = (unsigned)(elem->get<float>("delay") * 1000.0f);
+	if((properties & ThemeFlags::DELAY) && elem->has(ThemeProperty::DELAY))
+		mConfig.startDelay = (unsigned)(elem->get<float>(ThemeProperty::DELAY) * 1000.0f);
 
-	if (elem->has("showSnapshotNoVideo"))
-		mConfig.showSnapshotNoVideo = elem->get<bool>("showSnapshotNoVideo");
+	if (elem->has(ThemeProperty::SHOW_SNAPSHOT_NO_VIDEO))
+		mConfig.showSnapshotNoVideo = elem->get<bool>(ThemeProperty::SHOW_SNAPSHOT_NO_VIDEO);
 
-	if (elem->has("showSnapshotDelay"))
-		mConfig.showSnapshotDelay = elem->get<bool>("showSnapshotDelay");
+	if (elem->has(ThemeProperty::SHOW_SNAPSHOT_DELAY))
+		mConfig.showSnapshotDelay = elem->get<bool>(ThemeProperty::SHOW_SNAPSHOT_DELAY);
 }
 
 std::vector<HelpPrompt> VideoComponent::getHelpPrompts()
@@ -263,6 +263,12 @@ void VideoComponent::startVideoWithDelay()
 	}
 }
 
+bool VideoComponent::isAnimating() const
+{
+	// a playing video delivers new frames on its own, a delayed one will start or fade in later
+	return mIsPlaying || mStartDelayed || mFadeIn < 1.0f || GuiComponent::isAnimating();
+}
+
 void VideoComponent::update(int deltaTime)
 {
 	manageState();
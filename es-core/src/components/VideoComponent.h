@@ -58,6 +58,8 @@ public:
 
 	virtual void update(int deltaTime) override;
 
+	virtual bool isAnimating() const override;
+
 	// Resize the video to fit this size. If one axis is zero, scale that axis to maintain aspect ratio.
 	// If both are non-zero, potentially break the aspect ratio.  If both are zero, no resizing.
 	// Can be set before or after a video is loaded.
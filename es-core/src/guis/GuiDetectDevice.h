@@ -15,6 +15,7 @@ public:
 
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
+	bool isAnimating() const override { return mHoldingConfig != NULL || GuiComponent::isAnimating(); }
 	void onSizeChanged() override;
 
 private:
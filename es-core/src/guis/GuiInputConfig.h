@@ -16,6 +16,7 @@ public:
 	GuiInputConfig(Window* window, InputConfig* target, bool reconfigureAll, const std::function<void()>& okCallback);
 
 	void update(int deltaTime) override;
+	bool isAnimating() const override { return mHoldingInput || GuiComponent::isAnimating(); }
 
 	void onSizeChanged() override;
 
@@ -24,6 +24,8 @@ namespace Renderer
 	static int              screenOffsetY      = 0;
 	static int              screenRotate       = 0;
 	static bool             initialCursorState = 1;
+	static unsigned int     bindsRequested     = 0;
+	static unsigned int     bindsDone          = 0;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -291,4 +293,26 @@ namespace Renderer
 	int         getScreenOffsetY() { return screenOffsetY; }
 	int         getScreenRotate()  { return screenRotate; }
 
+//////////////////////////////////////////////////////////////////////////
+
+	void countTextureBind(const bool _bound)
+	{
+		++bindsRequested;
+
+		if(_bound)
+			++bindsDone;
+
+	} // countTextureBind
+
+//////////////////////////////////////////////////////////////////////////
+
+	void getTextureBinds(unsigned int& _requested, unsigned int& _bound)
+	{
+		_requested     = bindsRequested;
+		_bound         = bindsDone;
+		bindsRequested = 0;
+		bindsDone      = 0;
+
+	} // getTextureBinds
+
 } // Renderer::
@@ -76,6 +76,8 @@ namespace Renderer
 	int         getScreenOffsetX();
 	int         getScreenOffsetY();
 	int         getScreenRotate ();
+	void        countTextureBind(const bool _bound);
+	void        getTextureBinds (unsigned int& _requested, unsigned int& _bound); // returns and resets the bind counters
 
 	// API specific
 	unsigned int convertColor      (const unsigned int _color);
@@ -31,6 +31,7 @@ namespace Renderer
 
 	static SDL_GLContext sdlContext   = nullptr;
 	static GLuint        whiteTexture = 0;
+	static GLuint        boundTexture = 0;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -155,6 +156,7 @@ namespace Renderer
 
 		GL_CHECK_ERROR(glGenTextures(1, &texture));
 		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+		boundTexture = texture;
 
 		GL_CHECK_ERROR(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 		GL_CHECK_ERROR(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE));
@@ -174,6 +176,9 @@ namespace Renderer
 	{
 		GL_CHECK_ERROR(glDeleteTextures(1, &_texture));
 
+		if(boundTexture == _texture)
+			boundTexture = 0;
+
 	} // destroyTexture
 
 //////////////////////////////////////////////////////////////////////////
@@ -185,6 +190,7 @@ namespace Renderer
 		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _texture));
 		GL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, _x, _y, _width, _height, type, GL_UNSIGNED_BYTE, _data));
 		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, whiteTexture));
+		boundTexture = whiteTexture;
 
 	} // updateTexture
 
@@ -192,8 +198,16 @@ namespace Renderer
 
 	void bindTexture(const unsigned int _texture)
 	{
-		if(_texture == 0) GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, whiteTexture));
-		else              GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _texture));
+		const GLuint texture = (_texture == 0) ? whiteTexture : _texture;
+
+		// skip rebinding the texture that is already bound, consecutive draws often share one
+		countTextureBind(texture != boundTexture);
+
+		if(texture != boundTexture)
+		{
+			GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+			boundTexture = texture;
+		}
 
 	} // bindTexture
 
@@ -39,6 +39,7 @@ namespace Renderer
 	static GLint         posAttrib        = 0;
 	static GLuint        vertexBuffer     = 0;
 	static GLuint        whiteTexture     = 0;
+	static GLuint        boundTexture     = 0;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -318,6 +319,7 @@ namespace Renderer
 
 		GL_CHECK_ERROR(glGenTextures(1, &texture));
 		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+		boundTexture = texture;
 
 		GL_CHECK_ERROR(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 		GL_CHECK_ERROR(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE));
@@ -356,6 +358,9 @@ namespace Renderer
 	{
 		GL_CHECK_ERROR(glDeleteTextures(1, &_texture));
 
+		if(boundTexture == _texture)
+			boundTexture = 0;
+
 	} // destroyTexture
 
 //////////////////////////////////////////////////////////////////////////
@@ -388,6 +393,7 @@ namespace Renderer
 		}
 
 		GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, whiteTexture));
+		boundTexture = whiteTexture;
 
 	} // updateTexture
 
@@ -395,8 +401,16 @@ namespace Renderer
 
 	void bindTexture(const unsigned int _texture)
 	{
-		if(_texture == 0) GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, whiteTexture));
-		else              GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, _texture));
+		const GLuint texture = (_texture == 0) ? whiteTexture : _texture;
+
+		// skip rebinding the texture that is already bound, consecutive draws often share one
+		countTextureBind(texture != boundTexture);
+
+		if(texture != boundTexture)
+		{
+			GL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+			boundTexture = texture;
+		}
 
 	} // bindTexture
 
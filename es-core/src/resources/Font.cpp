@@ -720,10 +720,10 @@ std::shared_ptr<Font> Font::getFromTheme(const ThemeData::ThemeElement* elem, un
 	std::string path = (orig ? orig->mPath : getDefaultPath());
 
 	float sh = (float)Renderer::getScreenHeight();
-	if(properties & FONT_SIZE && elem->has("fontSize"))
-		size = (int)(sh * elem->get<float>("fontSize"));
-	if(properties & FONT_PATH && elem->has("fontPath"))
-		path = elem->get<std::string>("fontPath");
+	if(properties & FONT_SIZE && elem->has(ThemeProperty::FONT_SIZE))
+		size = (int)(sh * elem->get<float>(ThemeProperty::FONT_SIZE));
+	if(properties & FONT_PATH && elem->has(ThemeProperty::FONT_PATH))
+		path = elem->get<std::string>(ThemeProperty::FONT_PATH);
 
 	return get(size, path);
 }
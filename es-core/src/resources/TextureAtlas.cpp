@@ -0,0 +1,182 @@
+#include "resources/TextureAtlas.h"
+
+#include "math/Misc.h"
+#include "renderers/Renderer.h"
+#include "Log.h"
+#include "Settings.h"
+#include <algorithm>
+#include <string.h>
+
+// the first page is small so a few icons don't take a large share of "MaxVRAM", later ones grow up to the max
+#define ATLAS_MIN_PAGE_SIZE 512
+#define ATLAS_MAX_PAGE_SIZE 2048
+// a single page never takes more than this share of "MaxVRAM"
+#define ATLAS_MAX_PAGE_VRAM_SHARE 8
+#define ATLAS_MAX_IMAGE_SIZE 512
+// border of duplicated edge pixels around each image so filtering doesn't pick up its neighbours
+#define ATLAS_PADDING 1
+
+std::vector<TextureAtlas::Page*> TextureAtlas::sPages;
+size_t                           TextureAtlas::sVRAMUsage = 0;
+
+TextureAtlas::Page::Page(int size) : textureSize(size, size), usedCount(0)
+{
+	textureId = Renderer::createTexture(Renderer::Texture::RGBA, true, false, textureSize.x(), textureSize.y(), nullptr);
+	if(textureId != 0)
+		sVRAMUsage += textureSize.x() * textureSize.y() * 4;
+}
+
+TextureAtlas::Page::~Page()
+{
+	if(textureId != 0)
+	{
+		Renderer::destroyTexture(textureId);
+		sVRAMUsage -= textureSize.x() * textureSize.y() * 4;
+	}
+}
+
+bool TextureAtlas::Page::findEmpty(const Vector2i& size, Slot& slot_out)
+{
+	// reuse the smallest free slot the image fits in
+	auto bestSlot = freeSlots.end();
+	for(auto it = freeSlots.begin(); it != freeSlots.end(); ++it)
+	{
+		if(it->size.x() >= size.x() && it->size.y() >= size.y() &&
+			(bestSlot == freeSlots.end() || (it->size.x() * it->size.y()) < (bestSlot->size.x() * bestSlot->size.y())))
+			bestSlot = it;
+	}
+
+	if(bestSlot != freeSlots.end())
+	{
+		slot_out = *bestSlot;
+		freeSlots.erase(bestSlot);
+		return true;
+	}
+
+	// find a shelf that is tall enough without wasting too much space
+	for(auto it = shelves.begin(); it != shelves.end(); ++it)
+	{
+		if(it->height >= size.y() && it->height <= size.y() + (size.y() / 2) && it->writeX + size.x() <= textureSize.x())
+		{
+			slot_out.pos = Vector2i(it->writeX, it->y);
+			slot_out.size = Vector2i(size.x(), it->height);
+			it->writeX += size.x();
+			return true;
+		}
+	}
+
+	// start a new shelf below the last one
+	const int shelfY = shelves.size() ? (shelves.back().y + shelves.back().height) : 0;
+	if(shelfY + size.y() > textureSize.y() || size.x() > textureSize.x())
+		return false;
+
+	Shelf shelf = { shelfY, size.y(), size.x() };
+	shelves.push_back(shelf);
+
+	slot_out.pos = Vector2i(0, shelfY);
+	slot_out.size = size;
+	return true;
+}
+
+int TextureAtlas::getNewPageSize(const Vector2i& size)
+{
+	// every page twice as large as the largest one so far
+	int pageSize = ATLAS_MIN_PAGE_SIZE;
+	for(auto it = sPages.cbegin(); it != sPages.cend(); ++it)
+		pageSize = std::max(pageSize, (*it)->textureSize.x() * 2);
+	pageSize = std::min(pageSize, ATLAS_MAX_PAGE_SIZE);
+
+	const size_t maxVRAM = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024;
+	while(maxVRAM > 0 && pageSize > ATLAS_MIN_PAGE_SIZE && (size_t)pageSize * pageSize * 4 > maxVRAM / ATLAS_MAX_PAGE_VRAM_SHARE)
+		pageSize /= 2;
+
+	// the image has to fit whatever the budget
+	while(pageSize < size.x() || pageSize < size.y())
+		pageSize *= 2;
+
+	return pageSize;
+}
+
+bool TextureAtlas::fits(size_t width, size_t height)
+{
+	return width > 0 && height > 0 && width <= ATLAS_MAX_IMAGE_SIZE && height <= ATLAS_MAX_IMAGE_SIZE;
+}
+
+bool TextureAtlas::add(const unsigned char* dataRGBA, size_t width, size_t height, Region& region_out)
+{
+	if(!fits(width, height) || dataRGBA == nullptr)
+		return false;
+
+	const Vector2i size((int)width + ATLAS_PADDING * 2, (int)height + ATLAS_PADDING * 2);
+
+	Page* page = nullptr;
+	Slot  slot;
+
+	for(auto it = sPages.cbegin(); it != sPages.cend(); ++it)
+	{
+		if((*it)->findEmpty(size, slot))
+		{
+			page = *it;
+			break;
+		}
+	}
+
+	if(page == nullptr)
+	{
+		page = new Page(getNewPageSize(size));
+		if(page->textureId == 0 || !page->findEmpty(size, slot))
+		{
+			LOG(LogError) << "Could not create texture atlas page for image of size " << width << "x" << height;
+			delete page;
+			return false;
+		}
+		sPages.push_back(page);
+	}
+
+	// copy the image into the middle of the padded block and repeat its edge pixels around it
+	std::vector<unsigned char> padded(size.x() * size.y() * 4);
+	for(int y = 0; y < size.y(); ++y)
+	{
+		const int            srcY = Math::clamp(y - ATLAS_PADDING, 0, (int)height - 1);
+		const unsigned char* src  = dataRGBA + (srcY * width * 4);
+		unsigned char*       dst  = &padded[y * size.x() * 4];
+
+		for(int x = 0; x < ATLAS_PADDING; ++x)
+		{
+			memcpy(dst + (x * 4), src, 4);
+			memcpy(dst + ((size.x() - 1 - x) * 4), src + ((width - 1) * 4), 4);
+		}
+
+		memcpy(dst + (ATLAS_PADDING * 4), src, width * 4);
+	}
+
+	Renderer::updateTexture(page->textureId, Renderer::Texture::RGBA, slot.pos.x(), slot.pos.y(), size.x(), size.y(), padded.data());
+	page->usedCount++;
+
+	const float pageWidth  = (float)page->textureSize.x();
+	const float pageHeight = (float)page->textureSize.y();
+
+	region_out.page = page;
+	region_out.slot = slot;
+	region_out.texRect = Vector4f((slot.pos.x() + ATLAS_PADDING) / pageWidth, (slot.pos.y() + ATLAS_PADDING) / pageHeight, width / pageWidth, height / pageHeight);
+
+	return true;
+}
+
+void TextureAtlas::remove(Region& region)
+{
+	Page* page = region.page;
+	if(page == nullptr)
+		return;
+
+	page->freeSlots.push_back(region.slot);
+	page->usedCount--;
+
+	if(page->usedCount <= 0)
+	{
+		sPages.erase(std::remove(sPages.begin(), sPages.end(), page), sPages.end());
+		delete page;
+	}
+
+	region = Region();
+}
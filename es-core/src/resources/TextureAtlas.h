@@ -0,0 +1,71 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_TEXTURE_ATLAS_H
+#define ES_CORE_RESOURCES_TEXTURE_ATLAS_H
+
+#include "math/Vector2i.h"
+#include "math/Vector4f.h"
+#include <stddef.h>
+#include <vector>
+
+// Packs small, static images into shared texture pages so consecutive draws of
+// logos, icons and frames can use the same texture without rebinding.
+// All functions must be called from the rendering thread.
+class TextureAtlas
+{
+public:
+	struct Slot
+	{
+		Vector2i pos;  // position of the padded slot in the page, in pixels
+		Vector2i size; // size of the padded slot, in pixels
+	};
+
+	struct Shelf
+	{
+		int y;
+		int height;
+		int writeX;
+	};
+
+	struct Page
+	{
+		unsigned int       textureId;
+		Vector2i           textureSize;
+		std::vector<Shelf> shelves;
+		std::vector<Slot>  freeSlots; // slots of removed images, reused for images that fit in them
+		int                usedCount;
+
+		Page(int size);
+		~Page();
+		bool findEmpty(const Vector2i& size, Slot& slot_out);
+	};
+
+	struct Region
+	{
+		Page*        page;
+		Slot         slot;
+		Vector4f     texRect; // x, y, w, h of the image in the page, in texture coordinates
+
+		Region() : page(nullptr), texRect(0, 0, 1, 1) { }
+	};
+
+	// returns true if an image of this size is small enough to be packed
+	static bool fits(size_t width, size_t height);
+
+	// uploads the image into a free slot of a page, creating a new page if needed
+	static bool add(const unsigned char* dataRGBA, size_t width, size_t height, Region& region_out);
+
+	// frees the slot, the page is destroyed once it holds no more images
+	static void remove(Region& region);
+
+	// returns the VRAM allocated for all pages, free space included (in bytes)
+	static size_t getVRAMUsage() { return sVRAMUsage; }
+
+private:
+	// size of the next page, small at first and larger as more pages are needed
+	static int getNewPageSize(const Vector2i& size);
+
+	static std::vector<Page*> sPages;
+	static size_t             sVRAMUsage;
+};
+
+#endif // ES_CORE_RESOURCES_TEXTURE_ATLAS_H
@@ -0,0 +1,351 @@
+#include "resources/TextureCache.h"
+
+#include "utils/FileSystemUtil.h"
+#include "Log.h"
+#include "Settings.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#if defined(_WIN32)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#define TEXTURE_CACHE_MAGIC "ESTC"
+#define TEXTURE_CACHE_VERSION 2
+// entries waiting to be written hold a copy of the pixels, drop new ones rather than pile them up
+#define TEXTURE_CACHE_MAX_PENDING 4
+// sanity limits for headers read back from disk
+#define TEXTURE_CACHE_MAX_PATH 4096
+#define TEXTURE_CACHE_MAX_SIZE 16384
+// pruning goes a bit under the limit so it doesn't run again after every write
+#define TEXTURE_CACHE_PRUNE_TARGET 0.9
+// entries used again are only marked as used this often, it's a write to the card every time
+#define TEXTURE_CACHE_TOUCH_SECONDS (24 * 60 * 60)
+
+struct TextureCacheHeader
+{
+	char     magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t sourceWidth;
+	uint32_t sourceHeight;
+	int64_t  sourceSize;
+	int64_t  sourceModified;
+	uint32_t pathLength;
+};
+
+// Writes cache entries on its own thread so a cache miss costs no more than a normal load
+class TextureCacheWriter
+{
+public:
+	TextureCacheWriter() : mExit(false), mThread(nullptr) { }
+
+	~TextureCacheWriter()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mExit = true;
+			mEvent.notify_one();
+		}
+
+		if(mThread != nullptr)
+		{
+			mThread->join();
+			delete mThread;
+		}
+	}
+
+	bool queue(const std::function<void()>& work)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if(mExit || mQueue.size() >= TEXTURE_CACHE_MAX_PENDING)
+			return false;
+
+		if(mThread == nullptr)
+			mThread = new std::thread(&TextureCacheWriter::threadProc, this);
+
+		mQueue.push_back(work);
+		mEvent.notify_one();
+		return true;
+	}
+
+private:
+	void threadProc()
+	{
+		while(true)
+		{
+			std::function<void()> work;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				while(!mExit && mQueue.empty())
+					mEvent.wait(lock);
+
+				if(mQueue.empty())
+					return;
+
+				work = mQueue.front();
+				mQueue.pop_front();
+			}
+			work();
+		}
+	}
+
+	std::list<std::function<void()>> mQueue;
+	std::mutex                       mMutex;
+	std::condition_variable          mEvent;
+	bool                             mExit;
+	std::thread*                     mThread;
+};
+
+static TextureCacheWriter sWriter;
+// size of the entries on disk, -1 until the cache was first pruned
+static std::atomic<long long> sCacheSize(-1);
+static std::atomic<bool>      sPruneQueued(false);
+
+bool TextureCache::isEnabled()
+{
+	return Settings::getInstance()->getBool("TextureCache");
+}
+
+std::string TextureCache::getKey(const std::string& path, size_t maxWidth, size_t maxHeight)
+{
+	// the same file is decoded at different sizes for different views, give each its own entry
+	if(maxWidth == 0 && maxHeight == 0)
+		return path;
+
+	return path + "@" + std::to_string(maxWidth) + "x" + std::to_string(maxHeight);
+}
+
+std::string TextureCache::getCachePath(const std::string& key)
+{
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long)std::hash<std::string>()(key);
+	return Utils::FileSystem::getHomePath() + "/.emulationstation/cache/textures/" + ss.str() + ".rgba";
+}
+
+bool TextureCache::load(const std::string& path, size_t maxWidth, size_t maxHeight, std::vector<unsigned char>& dataRGBA_out, size_t& width_out, size_t& height_out, size_t& sourceWidth_out, size_t& sourceHeight_out)
+{
+	// clean up what previous runs left behind, once
+	bool expected = false;
+	if(sCacheSize < 0 && sPruneQueued.compare_exchange_strong(expected, true))
+	{
+		if(!sWriter.queue([] { prune(); }))
+			sPruneQueued = false;
+	}
+
+	const std::string key = getKey(path, maxWidth, maxHeight);
+	const std::string cachePath = getCachePath(key);
+
+	std::ifstream stream(cachePath, std::ios::binary);
+	if(!stream.is_open())
+		return false;
+
+	TextureCacheHeader header;
+	if(!stream.read((char*)&header, sizeof(header)) || memcmp(header.magic, TEXTURE_CACHE_MAGIC, 4) != 0 || header.version != TEXTURE_CACHE_VERSION)
+		return false;
+
+	if(header.pathLength > TEXTURE_CACHE_MAX_PATH || header.width > TEXTURE_CACHE_MAX_SIZE || header.height > TEXTURE_CACHE_MAX_SIZE)
+		return false;
+
+	// different files can end up with the same name, make sure this entry is for this file and size
+	std::string entryKey(header.pathLength, '\0');
+	if(!stream.read(&entryKey[0], header.pathLength) || entryKey != key)
+		return false;
+
+	// the source changed since the entry was written
+	if(header.sourceSize != Utils::FileSystem::getFileSize(path) || header.sourceModified != Utils::FileSystem::getModificationTime(path))
+		return false;
+
+	dataRGBA_out.resize((size_t)header.width * header.height * 4);
+	if(dataRGBA_out.empty() || !stream.read((char*)dataRGBA_out.data(), dataRGBA_out.size()))
+	{
+		dataRGBA_out.clear();
+		return false;
+	}
+
+	width_out = header.width;
+	height_out = header.height;
+	sourceWidth_out = header.sourceWidth;
+	sourceHeight_out = header.sourceHeight;
+
+	// the modification time of an entry is roughly when it was last used, pruning goes by it
+	stream.close();
+	if((long long)time(nullptr) - Utils::FileSystem::getModificationTime(cachePath) > TEXTURE_CACHE_TOUCH_SECONDS)
+		utime(cachePath.c_str(), nullptr);
+	return true;
+}
+
+bool TextureCache::isStale(const std::string& cachePath)
+{
+	std::ifstream stream(cachePath, std::ios::binary);
+	if(!stream.is_open())
+		return true;
+
+	TextureCacheHeader header;
+	if(!stream.read((char*)&header, sizeof(header)) || memcmp(header.magic, TEXTURE_CACHE_MAGIC, 4) != 0 || header.version != TEXTURE_CACHE_VERSION)
+		return true;
+
+	if(header.pathLength > TEXTURE_CACHE_MAX_PATH)
+		return true;
+
+	std::string key(header.pathLength, '\0');
+	if(!stream.read(&key[0], header.pathLength))
+		return true;
+
+	// the key is the path of the source, followed by the max size it was decoded for if it had one
+	std::string path = key;
+	const size_t at = key.rfind('@');
+	if(at != std::string::npos)
+	{
+		const std::string size = key.substr(at + 1);
+		const size_t x = size.find('x');
+		if(x != std::string::npos && x > 0 && x < size.size() - 1 && size.find_first_not_of("0123456789x") == std::string::npos)
+			path = key.substr(0, at);
+	}
+
+	return header.sourceSize != Utils::FileSystem::getFileSize(path) || header.sourceModified != Utils::FileSystem::getModificationTime(path);
+}
+
+void TextureCache::prune()
+{
+	struct CacheFile
+	{
+		std::string path;
+		long long   size;
+		long long   used;
+	};
+
+	const long long maxSize = (long long)Settings::getInstance()->getInt("TextureCacheSize") * 1024 * 1024;
+	const std::string directory = Utils::FileSystem::getParent(getCachePath(""));
+
+	std::vector<CacheFile> files;
+	long long size = 0;
+	unsigned int removed = 0;
+
+	const Utils::FileSystem::stringList contents = Utils::FileSystem::getDirContent(directory);
+	for(auto it = contents.cbegin(); it != contents.cend(); it++)
+	{
+		// only the writer thread writes entries and this runs on it, any temporary file was left by a crash
+		if(Utils::FileSystem::getExtension(*it) != ".rgba" || isStale(*it))
+		{
+			if(Utils::FileSystem::removeFile(*it))
+				removed++;
+			continue;
+		}
+
+		CacheFile file;
+		file.path = *it;
+		file.size = Utils::FileSystem::getFileSize(*it);
+		file.used = Utils::FileSystem::getModificationTime(*it);
+		files.push_back(file);
+		size += file.size;
+	}
+
+	if(maxSize > 0 && size > maxSize)
+	{
+		std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.used < b.used; });
+
+		const long long target = (long long)(maxSize * TEXTURE_CACHE_PRUNE_TARGET);
+		for(auto it = files.cbegin(); it != files.cend() && size > target; it++)
+		{
+			if(Utils::FileSystem::removeFile(it->path))
+			{
+				size -= it->size;
+				removed++;
+			}
+		}
+	}
+
+	if(removed > 0)
+		LOG(LogDebug) << "Pruned " << removed << " texture cache entries, " << (size / 1024) << "KB left";
+
+	sCacheSize = size;
+	sPruneQueued = false;
+}
+
+void TextureCache::save(const std::string& path, size_t maxWidth, size_t maxHeight, const unsigned char* dataRGBA, size_t width, size_t height, size_t sourceWidth, size_t sourceHeight)
+{
+	if(dataRGBA == nullptr || width == 0 || height == 0)
+		return;
+
+	const std::string key = getKey(path, maxWidth, maxHeight);
+	std::shared_ptr<std::vector<unsigned char>> pixels = std::make_shared<std::vector<unsigned char>>(dataRGBA, dataRGBA + (width * height * 4));
+	sWriter.queue([path, key, pixels, width, height, sourceWidth, sourceHeight] { write(path, key, *pixels, width, height, sourceWidth, sourceHeight); });
+}
+
+void TextureCache::write(const std::string& path, const std::string& key, const std::vector<unsigned char>& dataRGBA, size_t width, size_t height, size_t sourceWidth, size_t sourceHeight)
+{
+	const std::string cachePath = getCachePath(key);
+	const std::string tempPath = cachePath + ".tmp";
+
+	Utils::FileSystem::createDirectory(Utils::FileSystem::getParent(cachePath));
+
+	TextureCacheHeader header;
+	memcpy(header.magic, TEXTURE_CACHE_MAGIC, 4);
+	header.version = TEXTURE_CACHE_VERSION;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.sourceWidth = (uint32_t)sourceWidth;
+	header.sourceHeight = (uint32_t)sourceHeight;
+	header.sourceSize = Utils::FileSystem::getFileSize(path);
+	header.sourceModified = Utils::FileSystem::getModificationTime(path);
+	header.pathLength = (uint32_t)key.size();
+
+	{
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		if(!stream.is_open())
+		{
+			LOG(LogWarning) << "Could not write texture cache entry " << cachePath;
+			return;
+		}
+
+		stream.write((const char*)&header, sizeof(header));
+		stream.write(key.c_str(), key.size());
+		stream.write((const char*)dataRGBA.data(), dataRGBA.size());
+
+		if(!stream.good())
+		{
+			stream.close();
+			remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	const long long replacedSize = Utils::FileSystem::exists(cachePath) ? Utils::FileSystem::getFileSize(cachePath) : 0;
+
+	// readers never see a half written entry, windows won't rename over an existing file
+	if(rename(tempPath.c_str(), cachePath.c_str()) != 0)
+	{
+		remove(cachePath.c_str());
+		if(rename(tempPath.c_str(), cachePath.c_str()) != 0)
+		{
+			remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	// the first prune finds this entry on disk by itself
+	if(sCacheSize < 0)
+		return;
+
+	sCacheSize += Utils::FileSystem::getFileSize(cachePath) - replacedSize;
+
+	const long long maxSize = (long long)Settings::getInstance()->getInt("TextureCacheSize") * 1024 * 1024;
+	if(maxSize > 0 && sCacheSize > maxSize)
+		prune();
+}
@@ -0,0 +1,34 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_TEXTURE_CACHE_H
+#define ES_CORE_RESOURCES_TEXTURE_CACHE_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// Keeps the decoded RGBA pixels of image files in ~/.emulationstation/cache/textures so
+// artwork doesn't have to go through the image decoder every time it is loaded.
+// Entries are tied to the size and modification time of the source file and are
+// rewritten when it changes. Entries of files that changed or are gone, and the least
+// recently used ones once the cache is over "TextureCacheSize" (in MB), are pruned when
+// the cache is first used and whenever writes take it over that size.
+class TextureCache
+{
+public:
+	static bool isEnabled();
+
+	// returns true and fills the pixels if there is an up to date entry for the file decoded for this max size
+	static bool load(const std::string& path, size_t maxWidth, size_t maxHeight, std::vector<unsigned char>& dataRGBA_out, size_t& width_out, size_t& height_out, size_t& sourceWidth_out, size_t& sourceHeight_out);
+
+	// copies the pixels and writes the entry in the background
+	static void save(const std::string& path, size_t maxWidth, size_t maxHeight, const unsigned char* dataRGBA, size_t width, size_t height, size_t sourceWidth, size_t sourceHeight);
+
+private:
+	static std::string getKey(const std::string& path, size_t maxWidth, size_t maxHeight);
+	static std::string getCachePath(const std::string& key);
+	static bool isStale(const std::string& cachePath);
+	static void prune();
+	static void write(const std::string& path, const std::string& key, const std::vector<unsigned char>& dataRGBA, size_t width, size_t height, size_t sourceWidth, size_t sourceHeight);
+};
+
+#endif // ES_CORE_RESOURCES_TEXTURE_CACHE_H
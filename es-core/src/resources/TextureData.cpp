@@ -3,8 +3,11 @@
 #include "math/Misc.h"
 #include "renderers/Renderer.h"
 #include "resources/ResourceManager.h"
+#include "resources/TextureCache.h"
+#include "utils/TracingUtil.h"
 #include "ImageIO.h"
 #include "Log.h"
+#include "Settings.h"
 #include <nanosvg/nanosvg.h>
 #include <nanosvg/nanosvgrast.h>
 #include <assert.h>
@@ -12,8 +15,12 @@
 
 #define DPI 96
 
-TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mDataRGBA(nullptr), mScalable(false),
-									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f)
+std::atomic<size_t> TextureData::sRAMUsage(0);
+std::atomic<size_t> TextureData::sVRAMUsage(0);
+
+TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mScalable(false), mReloadable(false),
+									  mWidth(0), mHeight(0), mMaxWidth(0), mMaxHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f),
+									  mRAMUsage(0), mVRAMUsage(0)
 {
 }
 
@@ -35,7 +42,7 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 {
 	// If already initialised then don't read again
 	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA)
+	if (!mDataRGBA.empty())
 		return true;
 
 	// nsvgParse excepts a modifiable, null-terminated string
@@ -63,78 +70,129 @@ bool TextureData::initSVGFromMemory(const unsigned char* fileData, size_t length
 	mWidth = (size_t)Math::round(mSourceWidth);
 	mHeight = (size_t)Math::round(mSourceHeight);
 
-	unsigned char* dataRGBA = new unsigned char[mWidth * mHeight * 4];
+	mDataRGBA.resize(mWidth * mHeight * 4);
 
 	NSVGrasterizer* rast = nsvgCreateRasterizer();
 	float scale = Math::min(mHeight / svgImage->height, mWidth / svgImage->width);
-	nsvgRasterize(rast, svgImage, 0, 0, scale, dataRGBA, (int)mWidth, (int)mHeight, (int)mWidth * 4);
+	nsvgRasterize(rast, svgImage, 0, 0, scale, mDataRGBA.data(), (int)mWidth, (int)mHeight, (int)mWidth * 4);
 	nsvgDeleteRasterizer(rast);
 	nsvgDelete(svgImage);
 
-	ImageIO::flipPixelsVert(dataRGBA, mWidth, mHeight);
-
-	mDataRGBA = dataRGBA;
+	ImageIO::flipPixelsVert(mDataRGBA.data(), mWidth, mHeight);
+	updateUsage();
 
 	return true;
 }
 
 bool TextureData::initImageFromMemory(const unsigned char* fileData, size_t length)
 {
-	size_t width, height;
+	size_t width, height, sourceWidth, sourceHeight;
 
 	// If already initialised then don't read again
 	{
 		std::unique_lock<std::mutex> lock(mMutex);
-		if (mDataRGBA)
+		if (!mDataRGBA.empty())
 			return true;
 	}
 
-	std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32((const unsigned char*)(fileData), length, width, height);
+	std::vector<unsigned char> imageRGBA = ImageIO::loadFromMemoryRGBA32((const unsigned char*)(fileData), length, width, height, mMaxWidth, mMaxHeight, sourceWidth, sourceHeight);
 	if (imageRGBA.size() == 0)
 	{
 		LOG(LogError) << "Could not initialize texture from memory, invalid data!  (file path: " << mPath << ", data ptr: " << (size_t)fileData << ", reported size: " << length << ")";
 		return false;
 	}
 
-	mSourceWidth = (float) width;
-	mSourceHeight = (float) height;
+	mSourceWidth = (float) sourceWidth;
+	mSourceHeight = (float) sourceHeight;
 	mScalable = false;
 
-	return initFromRGBA(imageRGBA.data(), width, height);
+	return initFromRGBA(imageRGBA, width, height);
+}
+
+bool TextureData::initImageFromCache()
+{
+	size_t width, height, sourceWidth, sourceHeight;
+
+	// If already initialised then don't read again
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (!mDataRGBA.empty())
+			return true;
+	}
+
+	std::vector<unsigned char> imageRGBA;
+	if (!TextureCache::load(mPath, mMaxWidth, mMaxHeight, imageRGBA, width, height, sourceWidth, sourceHeight))
+		return false;
+
+	mSourceWidth = (float) sourceWidth;
+	mSourceHeight = (float) sourceHeight;
+	mScalable = false;
+
+	return initFromRGBA(imageRGBA, width, height);
 }
 
 bool TextureData::initFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height)
 {
 	// If already initialised then don't read again
 	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA)
+	if (!mDataRGBA.empty())
 		return true;
 
 	// Take a copy
-	mDataRGBA = new unsigned char[width * height * 4];
-	memcpy(mDataRGBA, dataRGBA, width * height * 4);
+	mDataRGBA.assign(dataRGBA, dataRGBA + (width * height * 4));
+	mWidth = width;
+	mHeight = height;
+	updateUsage();
+	return true;
+}
+
+bool TextureData::initFromRGBA(std::vector<unsigned char>& dataRGBA, size_t width, size_t height)
+{
+	// If already initialised then don't read again
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mDataRGBA.empty())
+		return true;
+
+	mDataRGBA.swap(dataRGBA);
 	mWidth = width;
 	mHeight = height;
+	updateUsage();
 	return true;
 }
 
 bool TextureData::load()
 {
+	TraceScopeArg("TextureData::load", mPath);
 	bool retval = false;
 
 	// Need to load. See if there is a file
 	if (!mPath.empty())
 	{
+		// is it an SVG?
+		const bool isSVG = (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg");
+
+		// Artwork on disk may already be decoded in the texture cache, built-in resources are small enough to decode
+		const bool useCache = !isSVG && mPath[0] != ':' && TextureCache::isEnabled();
+		if (useCache && initImageFromCache())
+			return true;
+
 		std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 		const ResourceData& data = rm->getFileData(mPath);
-		// is it an SVG?
-		if (mPath.substr(mPath.size() - 4, std::string::npos) == ".svg")
+		if (isSVG)
 		{
 			mScalable = true;
 			retval = initSVGFromMemory((const unsigned char*)data.ptr.get(), data.length);
 		}
 		else
+		{
 			retval = initImageFromMemory((const unsigned char*)data.ptr.get(), data.length);
+
+			if (retval && useCache)
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				TextureCache::save(mPath, mMaxWidth, mMaxHeight, mDataRGBA.data(), mWidth, mHeight, (size_t)mSourceWidth, (size_t)mSourceHeight);
+			}
+		}
 	}
 	return retval;
 }
@@ -142,7 +200,7 @@ bool TextureData::load()
 bool TextureData::isLoaded()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
-	if (mDataRGBA || (mTextureID != 0))
+	if (!mDataRGBA.empty() || (mTextureID != 0))
 		return true;
 	return false;
 }
@@ -158,16 +216,26 @@ bool TextureData::uploadAndBind()
 	else
 	{
 		// Load it if necessary
-		if (!mDataRGBA)
+		if (mDataRGBA.empty())
 		{
 			return false;
 		}
 		// Make sure we're ready to upload
-		if ((mWidth == 0) || (mHeight == 0) || (mDataRGBA == nullptr))
+		if ((mWidth == 0) || (mHeight == 0) || mDataRGBA.empty())
 			return false;
 
-		// Upload texture
-		mTextureID = Renderer::createTexture(Renderer::Texture::RGBA, true, mTile, (int)mWidth, (int)mHeight, mDataRGBA);
+		// Small images from files share atlas pages, anything tiled or generated at runtime gets its own texture
+		if(!mTile && mReloadable && Settings::getInstance()->getBool("TextureAtlas") && TextureAtlas::add(mDataRGBA.data(), mWidth, mHeight, mAtlasRegion))
+		{
+			mTextureID = mAtlasRegion.page->textureId;
+			Renderer::bindTexture(mTextureID);
+		}
+		else
+		{
+			// Upload texture
+			mTextureID = Renderer::createTexture(Renderer::Texture::RGBA, true, mTile, (int)mWidth, (int)mHeight, mDataRGBA.data());
+		}
+		updateUsage();
 	}
 	return true;
 }
@@ -177,16 +245,20 @@ void TextureData::releaseVRAM()
 	std::unique_lock<std::mutex> lock(mMutex);
 	if (mTextureID != 0)
 	{
-		Renderer::destroyTexture(mTextureID);
+		if (mAtlasRegion.page != nullptr)
+			TextureAtlas::remove(mAtlasRegion);
+		else
+			Renderer::destroyTexture(mTextureID);
 		mTextureID = 0;
+		updateUsage();
 	}
 }
 
 void TextureData::releaseRAM()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
-	delete[] mDataRGBA;
-	mDataRGBA = 0;
+	std::vector<unsigned char>().swap(mDataRGBA);
+	updateUsage();
 }
 
 size_t TextureData::width()
@@ -233,8 +305,26 @@ void TextureData::setSourceSize(float width, float height)
 
 size_t TextureData::getVRAMUsage()
 {
-	if ((mTextureID != 0) || (mDataRGBA != nullptr))
+	if ((mTextureID != 0) || !mDataRGBA.empty())
 		return mWidth * mHeight * 4;
 	else
 		return 0;
 }
+
+size_t TextureData::getDataSize()
+{
+	return mWidth * mHeight * 4;
+}
+
+void TextureData::updateUsage()
+{
+	// only the difference to what was counted before, so the totals never need a walk over every texture
+	const size_t ram = mDataRGBA.size();
+	// images packed into an atlas are counted with the pages they share
+	const size_t vram = (mTextureID != 0 && mAtlasRegion.page == nullptr) ? mWidth * mHeight * 4 : 0;
+
+	sRAMUsage += ram - mRAMUsage;
+	sVRAMUsage += vram - mVRAMUsage;
+	mRAMUsage = ram;
+	mVRAMUsage = vram;
+}
@@ -2,8 +2,11 @@
 #ifndef ES_CORE_RESOURCES_TEXTURE_DATA_H
 #define ES_CORE_RESOURCES_TEXTURE_DATA_H
 
+#include "resources/TextureAtlas.h"
+#include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 
 class TextureResource;
 
@@ -19,7 +22,9 @@ public:
 	void initFromPath(const std::string& path);
 	bool initSVGFromMemory(const unsigned char* fileData, size_t length);
 	bool initImageFromMemory(const unsigned char* fileData, size_t length);
+	bool initImageFromCache();
 	bool initFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
+	bool initFromRGBA(std::vector<unsigned char>& dataRGBA, size_t width, size_t height); // takes the pixels without copying them
 
 	// Read the data into memory if necessary
 	bool load();
@@ -38,6 +43,12 @@ public:
 
 	// Get the amount of VRAM currenty used by this texture
 	size_t getVRAMUsage();
+	// Get the size of the pixels once loaded without loading them, 0 if that isn't known yet
+	size_t getDataSize();
+
+	// Totals over all textures, kept up to date as pixels are decoded, uploaded and released
+	static size_t getTotalRAMUsage() { return sRAMUsage; }
+	static size_t getTotalVRAMUsage() { return sVRAMUsage + TextureAtlas::getVRAMUsage(); }
 
 	size_t width();
 	size_t height();
@@ -45,20 +56,37 @@ public:
 	float sourceHeight();
 	void setSourceSize(float width, float height);
 
+	// Raster images are decoded at the smallest size that still covers this, 0 = no limit on that axis
+	void setMaxSize(size_t width, size_t height) { mMaxWidth = width; mMaxHeight = height; }
+
 	bool tiled() { return mTile; }
 
+	// Get the part of the bound texture this texture occupies, (0, 0, 1, 1) unless it was packed into an atlas page
+	const Vector4f& getTextureRect() { return mAtlasRegion.texRect; }
+
 private:
+	// must be called with mMutex held after mDataRGBA or mTextureID changed
+	void updateUsage();
+
+	static std::atomic<size_t>	sRAMUsage;
+	static std::atomic<size_t>	sVRAMUsage;
+
 	std::mutex		mMutex;
 	bool			mTile;
 	std::string		mPath;
 	unsigned int	mTextureID;
-	unsigned char*	mDataRGBA;
+	std::vector<unsigned char>	mDataRGBA;
 	size_t			mWidth;
 	size_t			mHeight;
+	size_t			mMaxWidth;
+	size_t			mMaxHeight;
 	float			mSourceWidth;
 	float			mSourceHeight;
 	bool			mScalable;
 	bool			mReloadable;
+	TextureAtlas::Region	mAtlasRegion;
+	size_t			mRAMUsage;
+	size_t			mVRAMUsage;
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_H
@@ -1,10 +1,12 @@
 #include "resources/TextureDataManager.h"
 
 #include "resources/TextureData.h"
-#include "resources/TextureResource.h"
+#include "utils/TracingUtil.h"
+#include "Log.h"
 #include "Settings.h"
+#include <iterator>
 
-TextureDataManager::TextureDataManager()
+TextureDataManager::TextureDataManager() : mEvictedCount(0), mEvictedSize(0)
 {
 	unsigned char data[5 * 5 * 4];
 	mBlank = std::shared_ptr<TextureData>(new TextureData(false));
@@ -26,13 +28,21 @@ TextureDataManager::~TextureDataManager()
 
 std::shared_ptr<TextureData> TextureDataManager::add(const TextureResource* key, bool tiled)
 {
-	remove(key);
 	std::shared_ptr<TextureData> data(new TextureData(tiled));
-	mTextures.push_front(data);
-	mTextureLookup[key] = mTextures.cbegin();
+	add(key, data);
 	return data;
 }
 
+void TextureDataManager::add(const TextureResource* key, std::shared_ptr<TextureData> data)
+{
+	remove(key);
+	Entry entry;
+	entry.data = data;
+	entry.released = false;
+	mTextures.push_front(entry);
+	mTextureLookup[key] = mTextures.begin();
+}
+
 void TextureDataManager::remove(const TextureResource* key)
 {
 	// Find the entry in the list
@@ -40,27 +50,38 @@ void TextureDataManager::remove(const TextureResource* key)
 	if (it != mTextureLookup.cend())
 	{
 		// Remove the list entry
-		mTextures.erase((*it).second);
+		if ((*it).second->released)
+			mReleased.erase((*it).second);
+		else
+			mTextures.erase((*it).second);
 		// And the lookup
 		mTextureLookup.erase(it);
 	}
 }
 
+void TextureDataManager::touch(std::list<Entry>::iterator it)
+{
+	// Splicing keeps the iterator in the lookup valid
+	if (it->released)
+	{
+		mTextures.splice(mTextures.begin(), mReleased, it);
+		it->released = false;
+	}
+	else if (it != mTextures.begin())
+	{
+		mTextures.splice(mTextures.begin(), mTextures, it);
+	}
+}
+
 std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key, bool enableLoading)
 {
-	// If it's in the cache then we want to remove it from it's current location and
-	// move it to the top
+	// If it's in the cache then we want to move it to the top
 	std::shared_ptr<TextureData> tex;
 	auto it = mTextureLookup.find(key);
 	if (it != mTextureLookup.cend())
 	{
-		tex = *(*it).second;
-		// Remove the list entry
-		mTextures.erase((*it).second);
-		// Put it at the top
-		mTextures.push_front(tex);
-		// Store it back in the lookup
-		mTextureLookup[key] = mTextures.cbegin();
+		touch((*it).second);
+		tex = (*it).second->data;
 
 		// Make sure it's loaded or queued for loading
 		if (enableLoading && !tex->isLoaded())
@@ -69,7 +90,7 @@ std::shared_ptr<TextureData> TextureDataManager::get(const TextureResource* key,
 	return tex;
 }
 
-bool TextureDataManager::bind(const TextureResource* key)
+bool TextureDataManager::bind(const TextureResource* key, Vector4f& texRect_out)
 {
 	std::shared_ptr<TextureData> tex = get(key);
 	bool bound = false;
@@ -77,23 +98,28 @@ bool TextureDataManager::bind(const TextureResource* key)
 		bound = tex->uploadAndBind();
 	if (!bound)
 		mBlank->uploadAndBind();
+	texRect_out = bound ? tex->getTextureRect() : mBlank->getTextureRect();
 	return bound;
 }
 
 size_t TextureDataManager::getTotalSize()
 {
 	size_t total = 0;
-	for (auto tex : mTextures)
-		total += tex->width() * tex->height() * 4;
+	for (auto& entry : mTextures)
+		total += entry.data->width() * entry.data->height() * 4;
+	for (auto& entry : mReleased)
+		total += entry.data->width() * entry.data->height() * 4;
 	return total;
 }
 
 size_t TextureDataManager::getCommittedSize()
 {
-	size_t total = 0;
-	for (auto tex : mTextures)
-		total += tex->getVRAMUsage();
-	return total;
+	return TextureData::getTotalVRAMUsage();
+}
+
+size_t TextureDataManager::getRAMSize()
+{
+	return TextureData::getTotalRAMUsage();
 }
 
 size_t TextureDataManager::getQueueSize()
@@ -101,38 +127,68 @@ size_t TextureDataManager::getQueueSize()
 	return mLoader->getQueueSize();
 }
 
-void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
+void TextureDataManager::evict(const std::shared_ptr<TextureData>& keep)
 {
-	// See if it's already loaded
-	if (tex->isLoaded())
+	// if a budget is 0, then that memory should be considered unlimited
+	const size_t maxVRAM = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024;
+	const size_t maxRAM = (size_t)Settings::getInstance()->getInt("MaxTextureRAM") * 1024 * 1024;
+	if (maxVRAM == 0 && maxRAM == 0)
 		return;
-	// Not loaded. Make sure there is room
-	size_t max_texture = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024;
 
-	// if max_texture is 0, then texture memory should be considered unlimited
-	if (max_texture > 0)
+	unsigned int count = 0;
+	size_t size = 0;
+
+	while (!mTextures.empty() && mTextures.back().data != keep)
 	{
-		size_t size = TextureResource::getTotalMemUsage();
-		for (auto it = mTextures.crbegin(); it != mTextures.crend(); ++it)
+		// Queued textures will take both RAM and VRAM once loaded
+		const size_t queued = getQueueSize();
+		const bool overVRAM = (maxVRAM > 0) && (getCommittedSize() + queued >= maxVRAM);
+		const bool overRAM = (maxRAM > 0) && (getRAMSize() + queued >= maxRAM);
+		if (!overVRAM && !overRAM)
+			break;
+
+		auto it = std::prev(mTextures.end());
+		std::shared_ptr<TextureData> tex = it->data;
+		if (tex->isLoaded())
 		{
-			if (size < max_texture)
-				break;
-			//size -= (*it)->getVRAMUsage();
-			(*it)->releaseVRAM();
-			(*it)->releaseRAM();
-			// It may be already in the loader queue. In this case it wouldn't have been using
-			// any VRAM yet but it will be. Remove it from the loader queue
-			mLoader->remove(*it);
-			size = TextureResource::getTotalMemUsage();
+			size += tex->getDataSize();
+			count++;
 		}
+
+		tex->releaseVRAM();
+		tex->releaseRAM();
+		// It may be already in the loader queue. In this case it wouldn't have been using
+		// any VRAM yet but it will be. Remove it from the loader queue
+		mLoader->remove(tex);
+
+		// Nothing left to release, it only comes back to the list once it is used again
+		mReleased.splice(mReleased.begin(), mTextures, it);
+		it->released = true;
+	}
+
+	if (count > 0)
+	{
+		mEvictedCount += count;
+		mEvictedSize += size;
+		LOG(LogDebug) << "Evicted " << count << " textures (" << (size / 1024) << "KB), VRAM " << (getCommittedSize() / 1024) << "KB, RAM " <<
+			(getRAMSize() / 1024) << "KB, queued " << (getQueueSize() / 1024) << "KB";
 	}
+}
+
+void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
+{
+	// See if it's already loaded
+	if (tex->isLoaded())
+		return;
+	// Not loaded. Make sure there is room
+	evict(tex);
 	if (!block)
 		mLoader->load(tex);
 	else
 		tex->load();
 }
 
-TextureLoader::TextureLoader() : mExit(false)
+TextureLoader::TextureLoader() : mExit(false), mLoading(false), mCancelled(false), mLoadedCount(0), mQueueSize(0)
 {
 	mThread = new std::thread(&TextureLoader::threadProc, this);
 }
@@ -142,6 +198,7 @@ TextureLoader::~TextureLoader()
 	// Just abort any waiting texture
 	mTextureDataQ.clear();
 	mTextureDataLookup.clear();
+	mQueueSize = 0;
 
 	// Exit the thread
 	mExit = true;
@@ -152,6 +209,8 @@ TextureLoader::~TextureLoader()
 
 void TextureLoader::threadProc()
 {
+	Utils::Tracing::setThreadName("texture loader");
+
 	while (!mExit)
 	{
 		std::shared_ptr<TextureData> textureData;
@@ -161,9 +220,9 @@ void TextureLoader::threadProc()
 			mEvent.wait(lock);
 			if (!mTextureDataQ.empty())
 			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
+				textureData = erase(mTextureDataQ.cbegin());
+				mCurrent = textureData;
+				mLoading = true;
 			}
 		}
 		// Queue has been released here but we might have a texture to process
@@ -171,21 +230,34 @@ void TextureLoader::threadProc()
 		{
 			textureData->load();
 
+			std::unique_lock<std::mutex> lock(mMutex);
+			// Evicted while it was being decoded, nothing would ever release it again
+			if (mCancelled)
+				textureData->releaseRAM();
+			else
+				mLoadedCount++;
+			mCancelled = false;
+
 			// See if there is another item in the queue
 			textureData = nullptr;
-			std::unique_lock<std::mutex> lock(mMutex);
 			if (!mTextureDataQ.empty())
-			{
-				textureData = mTextureDataQ.front();
-				mTextureDataQ.pop_front();
-				mTextureDataLookup.erase(mTextureDataLookup.find(textureData.get()));
-			}
+				textureData = erase(mTextureDataQ.cbegin());
+			else
+				mLoading = false;
+			mCurrent = textureData;
 		}
 	}
 }
 
 void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 {
+	// Wanted again, keep it if it is being decoded right now
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (textureData == mCurrent)
+			mCancelled = false;
+	}
+
 	// Make sure it's not already loaded
 	if (!textureData->isLoaded())
 	{
@@ -193,14 +265,15 @@ void TextureLoader::load(std::shared_ptr<TextureData> textureData)
 		// Remove it from the queue if it is already there
 		auto td = mTextureDataLookup.find(textureData.get());
 		if (td != mTextureDataLookup.cend())
-		{
-			mTextureDataQ.erase((*td).second);
-			mTextureDataLookup.erase(td);
-		}
+			erase((*td).second);
 
 		// Put it on the start of the queue as we want the newly requested textures to load first
-		mTextureDataQ.push_front(textureData);
+		QueueEntry entry;
+		entry.data = textureData;
+		entry.size = textureData->getDataSize();
+		mTextureDataQ.push_front(entry);
 		mTextureDataLookup[textureData.get()] = mTextureDataQ.cbegin();
+		mQueueSize += entry.size;
 		mEvent.notify_one();
 	}
 }
@@ -211,21 +284,23 @@ void TextureLoader::remove(std::shared_ptr<TextureData> textureData)
 	std::unique_lock<std::mutex> lock(mMutex);
 	auto td = mTextureDataLookup.find(textureData.get());
 	if (td != mTextureDataLookup.cend())
-	{
-		mTextureDataQ.erase((*td).second);
-		mTextureDataLookup.erase(td);
-	}
+		erase((*td).second);
+	// Or release it as soon as it is decoded if that is happening now
+	else if (textureData == mCurrent)
+		mCancelled = true;
 }
 
-size_t TextureLoader::getQueueSize()
+std::shared_ptr<TextureData> TextureLoader::erase(std::list<QueueEntry>::const_iterator it)
+{
+	std::shared_ptr<TextureData> textureData = it->data;
+	mQueueSize -= it->size;
+	mTextureDataLookup.erase(textureData.get());
+	mTextureDataQ.erase(it);
+	return textureData;
+}
+
+bool TextureLoader::isLoading()
 {
-	// Gets the amount of video memory that will be used once all textures in
-	// the queue are loaded
-	size_t mem = 0;
 	std::unique_lock<std::mutex> lock(mMutex);
-	for (auto tex : mTextureDataQ)
-	{
-		mem += tex->width() * tex->height() * 4;
-	}
-	return mem;
+	return mLoading || !mTextureDataQ.empty();
 }
@@ -2,6 +2,8 @@
 #ifndef ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
 #define ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
 
+#include "math/Vector4f.h"
+#include <atomic>
 #include <condition_variable>
 #include <list>
 #include <map>
@@ -21,19 +23,38 @@ public:
 	void load(std::shared_ptr<TextureData> textureData);
 	void remove(std::shared_ptr<TextureData> textureData);
 
-	size_t getQueueSize();
+	// Size of the textures waiting in the queue, kept up to date as they are queued and taken off it
+	size_t getQueueSize() const { return mQueueSize; }
+
+	// True while textures are queued or being loaded in the background
+	bool isLoading();
+	// Number of textures loaded by the background thread so far, changes whenever a new one is ready to upload
+	unsigned int getLoadedCount() const { return mLoadedCount; }
 
 private:
+	struct QueueEntry
+	{
+		std::shared_ptr<TextureData>	data;
+		size_t							size; // what was added to mQueueSize for it
+	};
+
 	void processQueue();
 	void threadProc();
+	// must be called with mMutex held
+	std::shared_ptr<TextureData> erase(std::list<QueueEntry>::const_iterator it);
 
-	std::list<std::shared_ptr<TextureData> > 										mTextureDataQ;
-	std::map<TextureData*, std::list<std::shared_ptr<TextureData> >::const_iterator > 	mTextureDataLookup;
+	std::list<QueueEntry> 											mTextureDataQ;
+	std::map<TextureData*, std::list<QueueEntry>::const_iterator > 	mTextureDataLookup;
 
 	std::thread*				mThread;
 	std::mutex					mMutex;
 	std::condition_variable		mEvent;
 	bool 						mExit;
+	bool						mLoading;
+	std::shared_ptr<TextureData>	mCurrent; // being decoded by the thread
+	bool						mCancelled; // mCurrent was removed while it was decoded
+	std::atomic<unsigned int>	mLoadedCount;
+	std::atomic<size_t>			mQueueSize;
 };
 
 //
@@ -50,6 +71,10 @@ private:
 // to releaseRAM() which frees the memory buffer if the texture can be reloaded from
 // disk if needed again
 //
+// Textures that may hold memory are kept in least recently used order. When a load
+// would go over the "MaxVRAM" or "MaxTextureRAM" budget, the least recently used
+// textures are released until it fits and set aside until they are used again
+//
 class TextureDataManager
 {
 public:
@@ -57,6 +82,8 @@ public:
 	~TextureDataManager();
 
 	std::shared_ptr<TextureData> add(const TextureResource* key, bool tiled);
+	// Adds texture data that was already created, and possibly loaded, elsewhere
+	void add(const TextureResource* key, std::shared_ptr<TextureData> data);
 
 	// The texturedata being removed may be loading in a different thread. However it will
 	// be referenced by a smart point so we only need to remove it from our array and it
@@ -64,24 +91,48 @@ public:
 	void remove(const TextureResource* key);
 
 	std::shared_ptr<TextureData> get(const TextureResource* key, bool enableLoading = true);
-	bool bind(const TextureResource* key);
+	bool bind(const TextureResource* key, Vector4f& texRect_out);
 
 	// Get the total size of all textures managed by this object, loaded and unloaded in bytes
 	size_t	getTotalSize();
-	// Get the total size of all committed textures (in VRAM) in bytes
+	// Get the total size of all committed textures (in VRAM) in bytes, this counts every texture,
+	// not only the ones managed here
 	size_t	getCommittedSize();
+	// Get the total size of all decoded textures (in RAM) in bytes, this counts every texture,
+	// not only the ones managed here
+	size_t	getRAMSize();
 	// Get the total size of all load-pending textures in the queue - these will
 	// be committed to VRAM as the queue is processed
 	size_t  getQueueSize();
 	// Load a texture, freeing resources as necessary to make space
 	void load(std::shared_ptr<TextureData> tex, bool block = false);
 
-private:
+	bool isLoading() { return mLoader->isLoading(); }
+	unsigned int getLoadedCount() const { return mLoader->getLoadedCount(); }
+
+	// Number and total size of the textures released to stay within the budgets so far
+	unsigned int getEvictedCount() const { return mEvictedCount; }
+	size_t getEvictedSize() const { return mEvictedSize; }
 
-	std::list<std::shared_ptr<TextureData> >												mTextures;
-	std::map<const TextureResource*, std::list<std::shared_ptr<TextureData> >::const_iterator > 	mTextureLookup;
-	std::shared_ptr<TextureData>															mBlank;
-	TextureLoader*																			mLoader;
+private:
+	struct Entry
+	{
+		std::shared_ptr<TextureData>	data;
+		bool							released; // in mReleased rather than mTextures
+	};
+
+	// Moves an entry to the front of mTextures, wherever it is now
+	void touch(std::list<Entry>::iterator it);
+	// Releases least recently used textures, other than the one about to load, until usage is within the budgets
+	void evict(const std::shared_ptr<TextureData>& keep);
+
+	std::list<Entry>													mTextures; // most recently used first
+	std::list<Entry>													mReleased; // evicted and not used since
+	std::map<const TextureResource*, std::list<Entry>::iterator > 		mTextureLookup;
+	std::shared_ptr<TextureData>										mBlank;
+	TextureLoader*														mLoader;
+	unsigned int														mEvictedCount;
+	size_t																mEvictedSize;
 };
 
 #endif // ES_CORE_RESOURCES_TEXTURE_DATA_MANAGER_H
@@ -0,0 +1,281 @@
+#include "resources/TexturePrefetcher.h"
+
+#include "resources/TextureData.h"
+#include "resources/TextureResource.h"
+#include "utils/FileSystemUtil.h"
+#include "utils/StringUtil.h"
+#include "utils/TracingUtil.h"
+#include "Settings.h"
+#include <stdint.h>
+
+static bool isSameRequest(const TexturePrefetcher::Request& a, const TexturePrefetcher::Request& b)
+{
+	return a.path == b.path && a.tile == b.tile && a.maxSize == b.maxSize;
+}
+
+TexturePrefetcher& TexturePrefetcher::getInstance()
+{
+	static TexturePrefetcher instance;
+	return instance;
+}
+
+TexturePrefetcher::TexturePrefetcher() : mExit(false), mBudget(0)
+{
+	mStats.hits = 0;
+	mStats.late = 0;
+	mStats.wasted = 0;
+	mStats.bytes = 0;
+
+	mThread = new std::thread(&TexturePrefetcher::threadProc, this);
+}
+
+TexturePrefetcher::~TexturePrefetcher()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mExit = true;
+		mEvent.notify_one();
+	}
+
+	mThread->join();
+	delete mThread;
+}
+
+size_t TexturePrefetcher::getBudget() const
+{
+	const int maxVRAM = Settings::getInstance()->getInt("MaxVRAM");
+	const int percent = Settings::getInstance()->getInt("PrefetchVRAM");
+
+	// no limit on the textures, no limit on what is prefetched either
+	if(maxVRAM <= 0)
+		return SIZE_MAX;
+
+	return (size_t)maxVRAM * 1024 * 1024 / 100 * (size_t)percent;
+}
+
+void TexturePrefetcher::prefetch(const std::vector<Request>& requests)
+{
+	if(Settings::getInstance()->getInt("PrefetchVRAM") <= 0)
+	{
+		clear();
+		return;
+	}
+
+	// requests are keyed on the path they are shown with, the prefetch thread resolves them like
+	// TextureResource::get does. SVGs are rasterized at the size they are drawn at and aren't shared
+	std::vector<Request> wanted;
+	for(auto it = requests.cbegin(); it != requests.cend(); it++)
+	{
+		if(it->path.empty() || Utils::String::toLower(Utils::FileSystem::getExtension(it->path)) == ".svg")
+			continue;
+
+		wanted.push_back(*it);
+	}
+
+	const size_t budget = getBudget();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	std::list<std::shared_ptr<Entry>> entries;
+	for(auto request = wanted.cbegin(); request != wanted.cend(); request++)
+	{
+		bool found = false;
+		for(auto it = entries.cbegin(); it != entries.cend() && !found; it++)
+			found = isSameRequest((*it)->request, *request);
+
+		for(auto it = mEntries.begin(); it != mEntries.end() && !found; it++)
+		{
+			if(isSameRequest((*it)->request, *request))
+			{
+				found = true;
+
+				// already there, setImage won't have to wait for it
+				if(!(*it)->canonicalPath.empty() && TextureResource::isCached((*it)->canonicalPath, request->tile, request->maxSize))
+					break;
+
+				entries.splice(entries.end(), mEntries, it);
+			}
+		}
+
+		if(!found)
+		{
+			std::shared_ptr<Entry> entry(new Entry());
+			entry->request = *request;
+			entry->state = QUEUED;
+			entry->size = 0;
+			entry->dropped = false;
+			entries.push_back(entry);
+		}
+	}
+
+	// what isn't wanted anymore, because the cursor jumped or turned around
+	for(auto it = mEntries.cbegin(); it != mEntries.cend(); it++)
+		drop(*it);
+
+	mEntries.swap(entries);
+	mBudget = budget;
+
+	// the budget may have shrunk, the least wanted go first
+	for(auto it = mEntries.end(); it != mEntries.begin() && mStats.bytes > mBudget; )
+	{
+		it--;
+		if((*it)->state == READY)
+		{
+			drop(*it);
+			it = mEntries.erase(it);
+		}
+	}
+
+	mEvent.notify_one();
+}
+
+void TexturePrefetcher::clear()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	for(auto it = mEntries.cbegin(); it != mEntries.cend(); it++)
+		drop(*it);
+
+	mEntries.clear();
+}
+
+void TexturePrefetcher::drop(const std::shared_ptr<Entry>& entry)
+{
+	entry->dropped = true;
+
+	// textures being decoded are counted once they are done
+	if(entry->state == READY)
+	{
+		mStats.bytes -= entry->size;
+		mStats.wasted++;
+		entry->data.reset();
+	}
+}
+
+std::shared_ptr<TextureData> TexturePrefetcher::claim(const std::string& path, bool tile, const Vector2i& maxSize)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	for(auto it = mEntries.begin(); it != mEntries.end(); it++)
+	{
+		const Request& request = (*it)->request;
+		if((*it)->canonicalPath != path && request.path != path)
+			continue;
+
+		if(request.tile != tile || request.maxSize != maxSize)
+			continue;
+
+		std::shared_ptr<Entry> entry = *it;
+		mEntries.erase(it);
+
+		if(entry->state == QUEUED)
+		{
+			// the caller decodes it now
+			mStats.late++;
+			return nullptr;
+		}
+
+		if(entry->state == LOADING)
+		{
+			// decoding it again would take longer than waiting
+			mStats.late++;
+			while(entry->state == LOADING && !entry->dropped)
+				mLoaded.wait(lock);
+
+			if(entry->state != READY)
+				return nullptr;
+		}
+		else
+		{
+			mStats.hits++;
+		}
+
+		mStats.bytes -= entry->size;
+		return entry->data;
+	}
+
+	return nullptr;
+}
+
+TexturePrefetcher::Stats TexturePrefetcher::getStats()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+void TexturePrefetcher::threadProc()
+{
+	Utils::Tracing::setThreadName("texture prefetcher");
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(!mExit)
+	{
+		// the most wanted texture that isn't decoded yet, as long as there is room for it
+		std::shared_ptr<Entry> entry;
+		if(mStats.bytes < mBudget)
+		{
+			for(auto it = mEntries.cbegin(); it != mEntries.cend(); it++)
+			{
+				if((*it)->state == QUEUED)
+				{
+					entry = *it;
+					break;
+				}
+			}
+		}
+
+		if(!entry)
+		{
+			mEvent.wait(lock);
+			continue;
+		}
+
+		entry->state = LOADING;
+		const Request request = entry->request;
+		lock.unlock();
+
+		// resolved here instead of in prefetch(), that's a stat for every part of every path
+		const std::string canonicalPath = Utils::FileSystem::getCanonicalPath(request.path);
+
+		lock.lock();
+
+		entry->canonicalPath = canonicalPath;
+		if(entry->dropped || canonicalPath.empty() || Utils::String::toLower(Utils::FileSystem::getExtension(canonicalPath)) == ".svg")
+		{
+			// not wanted anymore or nothing TextureResource could take
+			entry->dropped = true;
+			mEntries.remove(entry);
+			mLoaded.notify_all();
+			continue;
+		}
+
+		lock.unlock();
+
+		std::shared_ptr<TextureData> data(new TextureData(request.tile));
+		data->initFromPath(canonicalPath);
+		data->setMaxSize(request.maxSize.x(), request.maxSize.y());
+		const bool loaded = data->load();
+
+		lock.lock();
+
+		if(!loaded)
+		{
+			// left to TextureResource, which logs the error
+			entry->dropped = true;
+			mEntries.remove(entry);
+		}
+		else if(entry->dropped)
+		{
+			mStats.wasted++;
+		}
+		else
+		{
+			entry->data = data;
+			entry->size = data->width() * data->height() * 4;
+			entry->state = READY;
+			mStats.bytes += entry->size;
+		}
+
+		mLoaded.notify_all();
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef ES_CORE_RESOURCES_TEXTURE_PREFETCHER_H
+#define ES_CORE_RESOURCES_TEXTURE_PREFETCHER_H
+
+#include "math/Vector2i.h"
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TextureData;
+
+// Decodes textures that will probably be shown soon on a background thread, so the TextureResource
+// created for them later takes the decoded data instead of blocking on the file. Every call to
+// prefetch() replaces what is wanted; decoded textures nobody asks for anymore are dropped. Decoded
+// textures wait in memory until they are claimed, within "PrefetchVRAM" percent of "MaxVRAM".
+class TexturePrefetcher
+{
+public:
+	struct Request
+	{
+		std::string path;
+		bool        tile;
+		Vector2i    maxSize;
+	};
+
+	struct Stats
+	{
+		unsigned int hits;   // claimed after they were decoded
+		unsigned int late;   // claimed while queued or decoding
+		unsigned int wasted; // decoded but dropped
+		size_t       bytes;  // decoded and waiting to be claimed
+	};
+
+	static TexturePrefetcher& getInstance();
+
+	// requests are in order of preference, the first is decoded first
+	void prefetch(const std::vector<Request>& requests);
+	void clear();
+
+	// takes the decoded data of a texture if it was prefetched, waits for it if it is being decoded,
+	// returns nullptr if it wasn't prefetched
+	std::shared_ptr<TextureData> claim(const std::string& path, bool tile, const Vector2i& maxSize);
+
+	Stats getStats();
+
+private:
+	enum State
+	{
+		QUEUED,
+		LOADING,
+		READY
+	};
+
+	struct Entry
+	{
+		Request                      request;
+		std::string                  canonicalPath; // resolved by the prefetch thread
+		std::shared_ptr<TextureData> data;
+		State                        state;
+		size_t                       size;
+		bool                         dropped;
+	};
+
+	TexturePrefetcher();
+	~TexturePrefetcher();
+
+	void threadProc();
+	void drop(const std::shared_ptr<Entry>& entry);
+	size_t getBudget() const;
+
+	std::list<std::shared_ptr<Entry>> mEntries; // most wanted first
+
+	std::mutex              mMutex;
+	std::condition_variable mEvent;  // something to decode
+	std::condition_variable mLoaded; // a texture was decoded
+	std::thread*            mThread;
+	bool                    mExit;
+	size_t                  mBudget;
+	Stats                   mStats;
+};
+
+#endif // ES_CORE_RESOURCES_TEXTURE_PREFETCHER_H
@@ -2,12 +2,13 @@
 
 #include "utils/FileSystemUtil.h"
 #include "resources/TextureData.h"
+#include "resources/TexturePrefetcher.h"
 
 TextureDataManager		TextureResource::sTextureDataManager;
 std::map< TextureResource::TextureKeyType, std::weak_ptr<TextureResource> > TextureResource::sTextureMap;
 std::set<TextureResource*> 	TextureResource::sAllTextures;
 
-TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic) : mTextureData(nullptr), mSize(0.0f, 0.0f), mSourceSize(0.0f, 0.0f), mForceLoad(false)
+TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic, const Vector2i& maxSize) : mTextureData(nullptr), mSize(0.0f, 0.0f), mSourceSize(0.0f, 0.0f), mTextureRect(0, 0, 1, 1), mMaxSize(maxSize), mForceLoad(false)
 {
 	// Create a texture data object for this texture
 	if (!path.empty())
@@ -17,16 +18,27 @@ TextureResource::TextureResource(const std::string& path, bool tile, bool dynami
 		std::shared_ptr<TextureData> data;
 		if (dynamic)
 		{
-			data = sTextureDataManager.add(this, tile);
-			data->initFromPath(path);
-			// Force the texture manager to load it using a blocking load
-			sTextureDataManager.load(data, true);
+			// Take it from the prefetcher if it was decoded in the background
+			data = TexturePrefetcher::getInstance().claim(path, tile, maxSize);
+			if (data != nullptr)
+			{
+				sTextureDataManager.add(this, data);
+			}
+			else
+			{
+				data = sTextureDataManager.add(this, tile);
+				data->initFromPath(path);
+				data->setMaxSize(maxSize.x(), maxSize.y());
+				// Force the texture manager to load it using a blocking load
+				sTextureDataManager.load(data, true);
+			}
 		}
 		else
 		{
 			mTextureData = std::shared_ptr<TextureData>(new TextureData(tile));
 			data = mTextureData;
 			data->initFromPath(path);
+			data->setMaxSize(maxSize.x(), maxSize.y());
 			// Load it so we can read the width/height
 			data->load();
 		}
@@ -92,15 +104,30 @@ bool TextureResource::bind()
 	if (mTextureData != nullptr)
 	{
 		mTextureData->uploadAndBind();
+		mTextureRect = mTextureData->getTextureRect();
 		return true;
 	}
 	else
 	{
-		return sTextureDataManager.bind(this);
+		return sTextureDataManager.bind(this, mTextureRect);
 	}
 }
 
-std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool forceLoad, bool dynamic)
+bool TextureResource::mapTextureCoords(const Renderer::Vertex* vertices, Renderer::Vertex* mapped_out, unsigned int count) const
+{
+	if (mTextureRect == Vector4f(0, 0, 1, 1))
+		return false;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		mapped_out[i] = vertices[i];
+		mapped_out[i].tex = Vector2f(mTextureRect.x() + (vertices[i].tex.x() * mTextureRect.z()), mTextureRect.y() + (vertices[i].tex.y() * mTextureRect.w()));
+	}
+
+	return true;
+}
+
+std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool forceLoad, bool dynamic, const Vector2i& maxSize)
 {
 	std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 
@@ -112,7 +139,7 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 		return tex;
 	}
 
-	TextureKeyType key(canonicalPath, tile);
+	TextureKeyType key(canonicalPath, tile, maxSize.x(), maxSize.y());
 	auto foundTexture = sTextureMap.find(key);
 	if(foundTexture != sTextureMap.cend())
 	{
@@ -122,11 +149,11 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 
 	// need to create it
 	std::shared_ptr<TextureResource> tex;
-	tex = std::shared_ptr<TextureResource>(new TextureResource(key.first, tile, dynamic));
+	tex = std::shared_ptr<TextureResource>(new TextureResource(canonicalPath, tile, dynamic, maxSize));
 	std::shared_ptr<TextureData> data = sTextureDataManager.get(tex.get());
 
 	// is it an SVG?
-	if(key.first.substr(key.first.size() - 4, std::string::npos) != ".svg")
+	if(canonicalPath.substr(canonicalPath.size() - 4, std::string::npos) != ".svg")
 	{
 		// Probably not. Add it to our map. We don't add SVGs because 2 svgs might be rasterized at different sizes
 		sTextureMap[key] = std::weak_ptr<TextureResource>(tex);
@@ -145,6 +172,12 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 	return tex;
 }
 
+bool TextureResource::isCached(const std::string& canonicalPath, bool tile, const Vector2i& maxSize)
+{
+	auto foundTexture = sTextureMap.find(TextureKeyType(canonicalPath, tile, maxSize.x(), maxSize.y()));
+	return foundTexture != sTextureMap.cend() && !foundTexture->second.expired();
+}
+
 // For scalable source images in textures we want to set the resolution to rasterize at
 void TextureResource::rasterizeAt(size_t width, size_t height)
 {
@@ -171,20 +204,18 @@ bool TextureResource::isInitialized() const
 
 size_t TextureResource::getTotalMemUsage()
 {
-	size_t total = 0;
-	// Count up all textures that manage their own texture data
-	for (auto tex : sAllTextures)
-	{
-		if (tex->mTextureData != nullptr)
-			total += tex->mTextureData->getVRAMUsage();
-	}
-	// Now get the committed memory from the manager
-	total += sTextureDataManager.getCommittedSize();
+	// The committed memory counts every texture, not only the managed ones
+	size_t total = sTextureDataManager.getCommittedSize();
 	// And the size of the loading queue
 	total += sTextureDataManager.getQueueSize();
 	return total;
 }
 
+size_t TextureResource::getTotalRAMUsage()
+{
+	return sTextureDataManager.getRAMSize();
+}
+
 size_t TextureResource::getTotalTextureSize()
 {
 	size_t total = 0;
@@ -199,6 +230,26 @@ size_t TextureResource::getTotalTextureSize()
 	return total;
 }
 
+bool TextureResource::isLoading()
+{
+	return sTextureDataManager.isLoading();
+}
+
+unsigned int TextureResource::getLoadedCount()
+{
+	return sTextureDataManager.getLoadedCount();
+}
+
+unsigned int TextureResource::getEvictedCount()
+{
+	return sTextureDataManager.getEvictedCount();
+}
+
+size_t TextureResource::getEvictedSize()
+{
+	return sTextureDataManager.getEvictedSize();
+}
+
 bool TextureResource::unload()
 {
 	// Release the texture's resources
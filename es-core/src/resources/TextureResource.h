@@ -4,10 +4,12 @@
 
 #include "math/Vector2i.h"
 #include "math/Vector2f.h"
+#include "renderers/Renderer.h"
 #include "resources/ResourceManager.h"
 #include "resources/TextureDataManager.h"
 #include <set>
 #include <string>
+#include <tuple>
 
 class TextureData;
 
@@ -16,7 +18,10 @@ class TextureData;
 class TextureResource : public IReloadable
 {
 public:
-	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool forceLoad = false, bool dynamic = true);
+	// maxSize asks for raster images to be decoded no larger than needed to cover that size, 0 = no limit on that axis
+	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool forceLoad = false, bool dynamic = true, const Vector2i& maxSize = Vector2i::Zero());
+	// returns true if get() would return an existing texture for these arguments
+	static bool isCached(const std::string& canonicalPath, bool tile, const Vector2i& maxSize);
 	void initFromPixels(const unsigned char* dataRGBA, size_t width, size_t height);
 	virtual void initFromMemory(const char* file, size_t length);
 
@@ -28,15 +33,26 @@ public:
 
 	bool isInitialized() const;
 	bool isTiled() const;
+	const Vector2i& getMaxSize() const { return mMaxSize; }
 
 	const Vector2i getSize() const;
 	bool bind();
 
+	// Copies the vertices with their texture coordinates mapped to the part of the bound texture this
+	// texture occupies. Returns false and leaves mapped_out untouched if the texture isn't in an atlas page
+	bool mapTextureCoords(const Renderer::Vertex* vertices, Renderer::Vertex* mapped_out, unsigned int count) const;
+
 	static size_t getTotalMemUsage(); // returns an approximation of total VRAM used by textures (in bytes)
+	static size_t getTotalRAMUsage(); // returns the total RAM used by decoded textures (in bytes)
 	static size_t getTotalTextureSize(); // returns the number of bytes that would be used if all textures were in memory
 
+	static bool isLoading(); // returns true while textures are still being loaded in the background
+	static unsigned int getLoadedCount(); // returns a counter that changes whenever a background load completes
+	static unsigned int getEvictedCount(); // returns the number of textures unloaded to stay within the memory budgets
+	static size_t getEvictedSize(); // returns the total size of the textures unloaded to stay within the memory budgets (in bytes)
+
 protected:
-	TextureResource(const std::string& path, bool tile, bool dynamic);
+	TextureResource(const std::string& path, bool tile, bool dynamic, const Vector2i& maxSize = Vector2i::Zero());
 	virtual bool unload();
 	virtual void reload();
 
@@ -50,9 +66,11 @@ private:
 
 	Vector2i					mSize;
 	Vector2f					mSourceSize;
+	Vector4f					mTextureRect;
+	Vector2i					mMaxSize;
 	bool							mForceLoad;
 
-	typedef std::pair<std::string, bool> TextureKeyType;
+	typedef std::tuple<std::string, bool, int, int> TextureKeyType;
 	static std::map< TextureKeyType, std::weak_ptr<TextureResource> > sTextureMap; // map of textures, used to prevent duplicate textures
 	static std::set<TextureResource*> 	sAllTextures;	// Set of all textures, used for memory management
 };
@@ -620,7 +620,8 @@ namespace Utils
 
 		bool createDirectory(const std::string& _path)
 		{
-			const std::string path = getGenericPath(_path);
+			const std::unique_lock<std::recursive_mutex> lock(mutex);
+			const std::string                            path = getGenericPath(_path);
 
 			// don't create if it already exists
 			if(exists(path))
@@ -762,6 +763,36 @@ namespace Utils
 
 		} // isHidden
 
+//////////////////////////////////////////////////////////////////////////
+
+		long long getFileSize(const std::string& _path)
+		{
+			const std::string path = getGenericPath(_path);
+			struct stat64     info;
+
+			// check if stat64 succeeded
+			if(stat64(path.c_str(), &info) != 0)
+				return -1;
+
+			return (long long)info.st_size;
+
+		} // getFileSize
+
+//////////////////////////////////////////////////////////////////////////
+
+		long long getModificationTime(const std::string& _path)
+		{
+			const std::string path = getGenericPath(_path);
+			struct stat64     info;
+
+			// check if stat64 succeeded
+			if(stat64(path.c_str(), &info) != 0)
+				return 0;
+
+			return (long long)info.st_mtime;
+
+		} // getModificationTime
+
 //////////////////////////////////////////////////////////////////////////
 
 #if !defined(_WIN32)
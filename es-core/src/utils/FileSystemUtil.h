@@ -39,6 +39,8 @@ namespace Utils
 		bool        isDirectory        (const std::string& _path);
 		bool        isSymlink          (const std::string& _path);
 		bool        isHidden           (const std::string& _path);
+		long long   getFileSize        (const std::string& _path);
+		long long   getModificationTime(const std::string& _path);
 #if !defined(_WIN32)
 		bool        isExecutable       (const std::string& _path);
 #endif // !_WIN32
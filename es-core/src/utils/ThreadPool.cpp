@@ -1,5 +1,7 @@
 #include "ThreadPool.h"
 
+#include "utils/TracingUtil.h"
+
 #if WIN32
 #include <Windows.h>
 #endif
@@ -16,6 +18,7 @@ namespace Utils
 			auto mask = (static_cast<DWORD_PTR>(1) << id);
 			SetThreadAffinityMask(GetCurrentThread(), mask);
 #endif
+			Utils::Tracing::setThreadName("pool " + std::to_string(id));
 
 			while (mRunning)
 			{
@@ -0,0 +1,234 @@
+#include "utils/TracingUtil.h"
+
+#include "Log.h"
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdio.h>
+#include <vector>
+
+// zones kept per thread, the oldest are overwritten once a thread recorded more
+#define TRACING_EVENTS_PER_THREAD 32768
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace Utils
+{
+	namespace Tracing
+	{
+		struct Event
+		{
+			const char* name;
+			uint64_t    begin;
+			uint64_t    duration;
+			char        arg[ARG_SIZE];
+
+		}; // Event
+
+		struct ThreadBuffer
+		{
+			std::vector<Event>    events;
+			std::atomic<uint64_t> count; // written by the owning thread only
+			unsigned int          id;
+			std::string           name;
+
+		}; // ThreadBuffer
+
+		std::atomic<bool> enabled(false);
+
+		static std::mutex                 sMutex; // guards the list of buffers, not their events
+		static std::vector<ThreadBuffer*> sBuffers;
+		static std::string                sPath;
+		static uint64_t                   sStart = 0;
+
+		static thread_local ThreadBuffer* tBuffer = nullptr;
+
+//////////////////////////////////////////////////////////////////////////
+
+		static ThreadBuffer* getThreadBuffer(void)
+		{
+			if(!tBuffer)
+			{
+				// buffers live until exit so threads that are done still show up in the trace
+				ThreadBuffer* buffer = new ThreadBuffer;
+				buffer->events.resize(TRACING_EVENTS_PER_THREAD);
+				buffer->count = 0;
+
+				std::unique_lock<std::mutex> lock(sMutex);
+				buffer->id   = (unsigned int)sBuffers.size() + 1;
+				buffer->name = "thread " + std::to_string(buffer->id);
+				sBuffers.push_back(buffer);
+
+				tBuffer = buffer;
+			}
+
+			return tBuffer;
+
+		} // getThreadBuffer
+
+//////////////////////////////////////////////////////////////////////////
+
+		static void writeString(std::ofstream& _stream, const char* _string)
+		{
+			_stream << '"';
+
+			for(const char* c = _string; *c; c++)
+			{
+				switch(*c)
+				{
+					case '"':  { _stream << "\\\""; } break;
+					case '\\': { _stream << "\\\\"; } break;
+					case '\n': { _stream << "\\n";  } break;
+					case '\r': { _stream << "\\r";  } break;
+					case '\t': { _stream << "\\t";  } break;
+					default:
+					{
+						if((unsigned char)*c < 0x20)
+						{
+							char escaped[8];
+							snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+							_stream << escaped;
+						}
+						else
+							_stream << *c;
+					}
+					break;
+				}
+			}
+
+			_stream << '"';
+
+		} // writeString
+
+//////////////////////////////////////////////////////////////////////////
+
+		void start(const std::string& _path)
+		{
+			sPath  = _path;
+			sStart = _now();
+			enabled.store(true);
+
+		} // start
+
+//////////////////////////////////////////////////////////////////////////
+
+		void write(void)
+		{
+			if(!isEnabled())
+				return;
+
+			enabled.store(false);
+
+			std::ofstream stream(sPath, std::ios::binary | std::ios::trunc);
+			if(!stream.is_open())
+			{
+				LOG(LogError) << "Could not write trace to " << sPath;
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(sMutex);
+
+			char     buffer[64];
+			uint64_t written = 0;
+			uint64_t dropped = 0;
+			bool     first   = true;
+
+			stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+			for(ThreadBuffer* threadBuffer : sBuffers)
+			{
+				stream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadBuffer->id << ",\"args\":{\"name\":";
+				writeString(stream, threadBuffer->name.c_str());
+				stream << "}}";
+				first = false;
+
+				const uint64_t count = threadBuffer->count.load(std::memory_order_acquire);
+				const uint64_t begin = (count > TRACING_EVENTS_PER_THREAD) ? (count - TRACING_EVENTS_PER_THREAD) : 0;
+				dropped += begin;
+
+				for(uint64_t i = begin; i < count; i++)
+				{
+					const Event& event = threadBuffer->events[i % TRACING_EVENTS_PER_THREAD];
+
+					// timestamps are in microseconds
+					snprintf(buffer, sizeof(buffer), "%.3f,\"dur\":%.3f", (event.begin - sStart) / 1000.0, event.duration / 1000.0);
+
+					stream << ",\n{\"name\":";
+					writeString(stream, event.name);
+					stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadBuffer->id << ",\"ts\":" << buffer;
+
+					if(event.arg[0])
+					{
+						stream << ",\"args\":{\"detail\":";
+						writeString(stream, event.arg);
+						stream << "}";
+					}
+
+					stream << "}";
+					written++;
+				}
+			}
+
+			stream << "\n]}\n";
+
+			LOG(LogInfo) << "Trace of " << written << " zones written to " << sPath << (dropped ? " (" + std::to_string(dropped) + " older zones were overwritten)" : "");
+
+		} // write
+
+//////////////////////////////////////////////////////////////////////////
+
+		void setThreadName(const std::string& _name)
+		{
+			if(!isEnabled())
+				return;
+
+			ThreadBuffer* threadBuffer = getThreadBuffer();
+
+			std::unique_lock<std::mutex> lock(sMutex);
+			threadBuffer->name = _name;
+
+		} // setThreadName
+
+//////////////////////////////////////////////////////////////////////////
+
+		uint64_t _now(void)
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		} // _now
+
+//////////////////////////////////////////////////////////////////////////
+
+		void _record(const char* _name, const char* _arg, const uint64_t _begin)
+		{
+			const uint64_t end          = _now();
+			ThreadBuffer*  threadBuffer = getThreadBuffer();
+			const uint64_t count        = threadBuffer->count.load(std::memory_order_relaxed);
+			Event&         event        = threadBuffer->events[count % TRACING_EVENTS_PER_THREAD];
+
+			event.name     = _name;
+			event.begin    = _begin;
+			event.duration = end - _begin;
+			strcpy(event.arg, _arg);
+
+			threadBuffer->count.store(count + 1, std::memory_order_release);
+
+		} // _record
+
+//////////////////////////////////////////////////////////////////////////
+
+		void Scope::setArg(const char* _arg, const size_t _length)
+		{
+			// keep the end, for paths that's the file name, without starting in the middle of a character
+			size_t offset = (_length >= ARG_SIZE) ? (_length - (ARG_SIZE - 1)) : 0;
+			while(offset > 0 && offset < _length && (_arg[offset] & 0xC0) == 0x80)
+				offset++;
+
+			memcpy(mArg, _arg + offset, _length - offset);
+			mArg[_length - offset] = '\0';
+
+		} // Scope::setArg
+
+	} // Tracing::
+
+} // Utils::
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef ES_CORE_UTILS_TRACING_UTIL_H
+#define ES_CORE_UTILS_TRACING_UTIL_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+// Timeline tracing, always compiled in and off unless started with --trace FILE.
+// Each thread records the zones it runs into its own ring buffer without locking, the
+// buffers are written at exit as Chrome trace event JSON, which chrome://tracing and
+// ui.perfetto.dev can open. When tracing is off a zone costs a single relaxed load.
+namespace Utils
+{
+	namespace Tracing
+	{
+		// length of the argument kept with a zone, longer arguments keep their end (file names)
+		static const size_t ARG_SIZE = 40;
+
+		extern std::atomic<bool> enabled;
+
+//////////////////////////////////////////////////////////////////////////
+
+		inline bool isEnabled(void) { return enabled.load(std::memory_order_relaxed); }
+
+		void     start        (const std::string& _path);
+		void     write        (void);
+		void     setThreadName(const std::string& _name);
+		uint64_t _now         (void);
+		void     _record      (const char* _name, const char* _arg, const uint64_t _begin);
+
+//////////////////////////////////////////////////////////////////////////
+
+		class Scope
+		{
+		public:
+
+			 Scope(const char* _name)                          : mName(_name), mActive(isEnabled()) { if(mActive) { mArg[0] = '\0'; mBegin = _now(); } }
+			 Scope(const char* _name, const char* _arg)        : mName(_name), mActive(isEnabled()) { if(mActive) { setArg(_arg, strlen(_arg)); mBegin = _now(); } }
+			 Scope(const char* _name, const std::string& _arg) : mName(_name), mActive(isEnabled()) { if(mActive) { setArg(_arg.c_str(), _arg.size()); mBegin = _now(); } }
+			~Scope(void)                                                                            { if(mActive) _record(mName, mArg, mBegin); }
+
+		private:
+
+			void setArg(const char* _arg, const size_t _length);
+
+			const char* mName;
+			bool        mActive;
+			uint64_t    mBegin;
+			char        mArg[ARG_SIZE];
+
+		}; // Scope
+
+	}; // Tracing::
+
+} // Utils::
+
+#define _tracingUnique(_name, _line) _name ## _line
+#define _tracingUniqueScope(_line)   _tracingUnique(traceScope, _line)
+#define __tracingUniqueScope         _tracingUniqueScope(__LINE__)
+
+// _name must be a string literal, it is kept as a pointer
+#define TraceScope(_name)            const Utils::Tracing::Scope __tracingUniqueScope(_name)
+#define TraceScopeArg(_name, _arg)   const Utils::Tracing::Scope __tracingUniqueScope(_name, _arg)
+
+#endif // ES_CORE_UTILS_TRACING_UTIL_H